@@ -181,6 +181,11 @@ uint16_t AbsoluteLoaderDataSource::GetStartAddress(void)
     return mLoadAddr + 2;
 }
 
+void AbsoluteLoaderDataSource::Rewind(void)
+{
+    mCurWord = 0;
+}
+
 uint16_t AbsoluteLoaderDataSource::MemSizeToLoadAddr(uint32_t memSizeKW)
 {
     if (memSizeKW < 4) {
@@ -31,6 +31,7 @@ public:
     virtual void Advance(void);
     virtual bool AtEnd(void);
     virtual uint16_t GetStartAddress(void);
+    virtual void Rewind(void);
 
     static uint16_t MemSizeToLoadAddr(uint32_t memSize);
 
@@ -65,6 +65,13 @@ void ActivityLED::Init(void)
 
 void ActivityLED::UpdateState(void)
 {
+#if defined(DUAL_CORE_MODE)
+    // In dual-core mode, the LEDs are updated exclusively by core1.
+    if (get_core_num() != 1) {
+        return;
+    }
+#endif
+
 #if defined(TX_ACTIVITY_LED_PIN)
     sTxLED.UpdateState();
 #endif
@@ -25,6 +25,8 @@
 AuxPort gAuxPort;
 
 SerialConfig AuxPort::sConfig = { AUX_DEFAULT_BAUD_RATE, 8, 1, SerialConfig::PARITY_NONE };
+BufferedUART AuxPort::sUARTBuf;
+uint32_t AuxPort::sDroppedCount;
 
 void AuxPort::Init(void)
 {
@@ -33,9 +35,30 @@ void AuxPort::Init(void)
     uart_set_fifo_enabled(AUX_TERM_UART, true);
     gpio_set_function(AUX_TERM_UART_RX_PIN, UART_FUNCSEL_NUM(AUX_TERM_UART, AUX_TERM_UART_RX_PIN));
     gpio_set_function(AUX_TERM_UART_TX_PIN, UART_FUNCSEL_NUM(AUX_TERM_UART, AUX_TERM_UART_TX_PIN));
+    sUARTBuf.Init(AUX_TERM_UART);
     SetConfig(sConfig);
 }
 
+void AuxPort::Forward(char ch, OverflowPolicy_t policy)
+{
+    switch (policy) {
+    case OverflowPolicy_DropOldest:
+        if (sUARTBuf.WriteDropOldest(ch)) {
+            sDroppedCount++;
+        }
+        break;
+    case OverflowPolicy_DropNewest:
+        if (!sUARTBuf.TryWrite(ch)) {
+            sDroppedCount++;
+        }
+        break;
+    default:
+        sUARTBuf.Write(ch);
+        break;
+    }
+    ActivityLED::SysActive();
+}
+
 void AuxPort::SetConfig(const SerialConfig& serialConfig)
 {
     // Wait for the UART transmission queue to empty.
@@ -33,16 +33,23 @@ public:
     void Init(void);
     const SerialConfig& GetConfig(void);
     void SetConfig(const SerialConfig& serialConfig);
+    uint32_t RxOverrunCount(void);
+    void Forward(char ch, OverflowPolicy_t policy);
+    uint32_t DroppedCount(void);
 
     virtual char Read(void);
     virtual bool TryRead(char &ch);
+    virtual size_t ReadSome(char * buf, size_t maxLen);
     virtual void Write(char ch);
     virtual void Write(const char * str);
     virtual void Flush(void);
     virtual bool CanWrite(void);
+    size_t WriteSpace(void);
 
 private:
     static SerialConfig sConfig;
+    static BufferedUART sUARTBuf;
+    static uint32_t sDroppedCount;
 };
 
 extern AuxPort gAuxPort;
@@ -52,43 +59,68 @@ inline const SerialConfig& AuxPort::GetConfig(void)
     return sConfig;
 }
 
+inline uint32_t AuxPort::RxOverrunCount(void)
+{
+    return sUARTBuf.RxOverrunCount();
+}
+
+inline uint32_t AuxPort::DroppedCount(void)
+{
+    return sDroppedCount;
+}
+
 inline char AuxPort::Read(void)
 {
-    char ch = uart_getc(AUX_TERM_UART);
-    ActivityLED::SysActive();
+    char ch;
+    while (!TryRead(ch)) {
+        tight_loop_contents();
+    }
     return ch;
 }
 
 inline bool AuxPort::TryRead(char& ch)
 {
-    if (uart_is_readable(AUX_TERM_UART)) {
-        ch = uart_getc(AUX_TERM_UART);
+    if (sUARTBuf.TryRead(ch)) {
         ActivityLED::SysActive();
         return true;
     }
     return false;
 }
 
+inline size_t AuxPort::ReadSome(char * buf, size_t maxLen)
+{
+    size_t len = sUARTBuf.ReadSome(buf, maxLen);
+    if (len > 0) {
+        ActivityLED::SysActive();
+    }
+    return len;
+}
+
 inline void AuxPort::Write(char ch)
 {
-    uart_putc(AUX_TERM_UART, ch);
+    sUARTBuf.Write(ch);
     ActivityLED::SysActive();
 }
 
 inline void AuxPort::Write(const char* str)
 {
-    uart_puts(AUX_TERM_UART, str);
+    sUARTBuf.Write(str);
     ActivityLED::SysActive();
 }
 
 inline void AuxPort::Flush(void)
 {
-    uart_tx_wait_blocking(AUX_TERM_UART);
+    sUARTBuf.Flush();
 }
 
 inline bool AuxPort::CanWrite(void)
 {
-    return uart_is_writable(SCL_UART);
+    return sUARTBuf.CanWrite();
+}
+
+inline size_t AuxPort::WriteSpace(void)
+{
+    return sUARTBuf.TxSpace();
 }
 
 #endif // defined(AUX_TERM_UART)
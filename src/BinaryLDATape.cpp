@@ -0,0 +1,80 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConsoleAdapter.h"
+#include "BinaryLDATape.h"
+
+size_t BinaryLDATape::TapeLength(size_t dataLen)
+{
+    // Full data blocks, plus a partial data block for any remaining data,
+    // plus the end block.
+    size_t fullBlocks = dataLen / kBlockDataLen;
+    size_t remLen = dataLen % kBlockDataLen;
+    return fullBlocks * (kBlockDataLen + kBlockOverhead) +
+           ((remLen > 0) ? remLen + kBlockOverhead : 0) +
+           kBlockOverhead;
+}
+
+uint8_t BinaryLDATape::ReadByte(size_t pos) const
+{
+    static constexpr size_t kBlockLen = kBlockDataLen + kBlockOverhead;
+
+    size_t blockIndex = pos / kBlockLen;
+    size_t offset = pos % kBlockLen;
+    size_t dataOffset = blockIndex * kBlockDataLen;
+    size_t dataLen;
+    uint16_t addr;
+
+    // Determine the length and load address of the block containing the
+    // requested byte.  If the position is beyond the last data block, the
+    // byte is part of the end block, which carries the start address.  An
+    // odd start address causes the Absolute Loader to halt once the tape has
+    // been read.
+    if (dataOffset < mDataLen && offset < (MIN(mDataLen - dataOffset, kBlockDataLen) + kBlockOverhead)) {
+        dataLen = MIN(mDataLen - dataOffset, kBlockDataLen);
+        addr = (uint16_t)(mLoadAddr + dataOffset);
+    }
+    else {
+        offset = pos - (TapeLength(mDataLen) - kBlockOverhead);
+        dataLen = 0;
+        addr = (mStartAddr != NO_ADDR) ? mStartAddr : 1;
+    }
+
+    const uint8_t * data = mDataBuf + dataOffset;
+    uint16_t byteCount = (uint16_t)(dataLen + 6);
+
+    // Return the requested byte of the block.  The block checksum is
+    // computed such that the sum of all bytes in the block is zero.
+    auto blockByte = [&](size_t i) -> uint8_t {
+        switch (i) {
+        case 0: return 1;
+        case 1: return 0;
+        case 2: return (uint8_t)byteCount;
+        case 3: return (uint8_t)(byteCount >> 8);
+        case 4: return (uint8_t)addr;
+        case 5: return (uint8_t)(addr >> 8);
+        default: return data[i - 6];
+        }
+    };
+    if (offset < dataLen + 6) {
+        return blockByte(offset);
+    }
+    uint8_t sum = 0;
+    for (size_t i = 0; i < dataLen + 6; i++) {
+        sum = (uint8_t)(sum + blockByte(i));
+    }
+    return (uint8_t)-sum;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BINARY_LDA_TAPE_H
+#define BINARY_LDA_TAPE_H
+
+/** Presents a raw binary image as a paper tape in Absolute Loader (LDA)
+ *  format.  Block headers, checksums and the final end block are generated
+ *  as the tape is read, without copying the image.
+ */
+class BinaryLDATape final : public TapeImage
+{
+public:
+    BinaryLDATape(void);
+    BinaryLDATape(const uint8_t * buf, size_t len, uint16_t loadAddr, uint16_t startAddr = NO_ADDR);
+    ~BinaryLDATape() = default;
+
+    virtual size_t Length(void) const;
+    virtual uint8_t ReadByte(size_t pos) const;
+    virtual const uint8_t * DataBuf(void) const;
+
+    static size_t TapeLength(size_t dataLen);
+
+private:
+    const uint8_t * mDataBuf;
+    size_t mDataLen;
+    uint16_t mLoadAddr;
+    uint16_t mStartAddr;
+
+    // Number of data bytes in each full block, and the number of bytes of
+    // block framing (header and checksum).
+    static constexpr size_t kBlockDataLen = 256;
+    static constexpr size_t kBlockOverhead = 7;
+};
+
+inline BinaryLDATape::BinaryLDATape(void)
+: mDataBuf(NULL), mDataLen(0), mLoadAddr(0), mStartAddr(NO_ADDR)
+{
+}
+
+inline BinaryLDATape::BinaryLDATape(const uint8_t * buf, size_t len, uint16_t loadAddr, uint16_t startAddr)
+: mDataBuf(buf), mDataLen(len), mLoadAddr(loadAddr), mStartAddr(startAddr)
+{
+}
+
+inline size_t BinaryLDATape::Length(void) const
+{
+    return TapeLength(mDataLen);
+}
+
+inline const uint8_t * BinaryLDATape::DataBuf(void) const
+{
+    return mDataBuf;
+}
+
+#endif // BINARY_LDA_TAPE_H
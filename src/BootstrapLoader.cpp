@@ -72,6 +72,11 @@ uint16_t BootstrapLoaderDataSource::GetStartAddress(void)
     return mLoadAddr;
 }
 
+void BootstrapLoaderDataSource::Rewind(void)
+{
+    mCurWord = 0;
+}
+
 uint16_t BootstrapLoaderDataSource::MemSizeToLoadAddr(uint32_t memSizeKW)
 {
     if (memSizeKW < 4) {
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConsoleAdapter.h"
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/uart.h"
+
+BufferedUART * BufferedUART::sInstances[NUM_UARTS];
+
+// NOTE: The interrupt handlers, and the functions they call, are placed in RAM
+// so that they continue to run on core1 while core0 is writing to flash.
+
+void BufferedUART::Init(uart_inst_t * uart)
+{
+    mUART = uart;
+    mRxBuf.Clear();
+    mRxOverrunCount = 0;
+
+    sInstances[uart_get_index(uart)] = this;
+
+    // Arrange to receive an interrupt whenever the UART's receive FIFO
+    // reaches its trigger level, or when characters have been sitting in
+    // the FIFO for a short period of time.
+    irq_set_exclusive_handler(UART_IRQ_NUM(uart),
+        (uart_get_index(uart) == 0) ? HandleUART0IRQ : HandleUART1IRQ);
+    irq_set_enabled(UART_IRQ_NUM(uart), true);
+    uart_set_irq_enables(uart, true, false);
+
+    // Setup a DMA channel to feed characters to the UART's transmit FIFO,
+    // paced by the UART's TX data request signal.
+    mTxBuf.Clear();
+    mTxActive = false;
+    // The lock is acquired while the paper tape reader's lock is held, so it
+    // uses a dedicated spin lock, rather than one shared with other critical
+    // sections (see PaperTapeReader::Init()).
+    critical_section_init_with_lock_num(&mTxLock, (uint)spin_lock_claim_unused(true));
+    mTxDMAChan = (uint)dma_claim_unused_channel(true);
+    dma_channel_config dmaConfig = dma_channel_get_default_config(mTxDMAChan);
+    channel_config_set_transfer_data_size(&dmaConfig, DMA_SIZE_8);
+    channel_config_set_read_increment(&dmaConfig, true);
+    channel_config_set_write_increment(&dmaConfig, false);
+    channel_config_set_dreq(&dmaConfig, uart_get_dreq(uart, true));
+    dma_channel_configure(mTxDMAChan, &dmaConfig, &uart_get_hw(uart)->dr, mTxChunk, 0, false);
+
+    // Arrange to receive an interrupt whenever a DMA transfer completes.
+    // The DMA interrupt handler is shared by all instances.
+    static bool sDMAIRQInstalled;
+    if (!sDMAIRQInstalled) {
+        irq_set_exclusive_handler(DMA_IRQ_0, HandleDMAIRQ);
+        irq_set_enabled(DMA_IRQ_0, true);
+        sDMAIRQInstalled = true;
+    }
+    dma_channel_set_irq0_enabled(mTxDMAChan, true);
+}
+
+bool BufferedUART::TryWrite(char ch)
+{
+    critical_section_enter_blocking(&mTxLock);
+
+    bool written = mTxBuf.Put(ch);
+
+    // Start a DMA transfer if one isn't already in progress.
+    if (written && !mTxActive) {
+        StartTx();
+    }
+
+    critical_section_exit(&mTxLock);
+
+    return written;
+}
+
+bool BufferedUART::WriteDropOldest(char ch)
+{
+    char discardCh;
+    bool dropped = false;
+
+    critical_section_enter_blocking(&mTxLock);
+
+    // If the transmit buffer is full, discard the oldest character to make
+    // room for the new one.  (This is safe because the consumer side of the
+    // buffer is only accessed while holding mTxLock).
+    if (mTxBuf.IsFull()) {
+        mTxBuf.Get(discardCh);
+        dropped = true;
+    }
+
+    mTxBuf.Put(ch);
+
+    // Start a DMA transfer if one isn't already in progress.
+    if (!mTxActive) {
+        StartTx();
+    }
+
+    critical_section_exit(&mTxLock);
+
+    return dropped;
+}
+
+void BufferedUART::Write(char ch)
+{
+    // Wait for space in the transmit buffer if necessary.
+    while (!TryWrite(ch)) {
+        tight_loop_contents();
+    }
+}
+
+void BufferedUART::Write(const char * str)
+{
+    while (*str != 0) {
+        critical_section_enter_blocking(&mTxLock);
+
+        // Queue as much of the string as will fit in the transmit buffer.
+        while (*str != 0 && mTxBuf.Put(*str)) {
+            str++;
+        }
+
+        // Start a DMA transfer if one isn't already in progress.
+        if (!mTxActive) {
+            StartTx();
+        }
+
+        critical_section_exit(&mTxLock);
+    }
+}
+
+void BufferedUART::Flush(void)
+{
+    // Wait for the transmit buffer to drain.
+    while (mTxActive || !mTxBuf.IsEmpty()) {
+        tight_loop_contents();
+    }
+
+    // Wait for the UART to finish sending the characters in its FIFO.
+    uart_tx_wait_blocking(mUART);
+}
+
+void __not_in_flash_func(BufferedUART::StartTx)(void)
+{
+    // NOTE: Must be called with mTxLock held.
+
+    // Move the next chunk of characters from the transmit buffer into
+    // the DMA buffer.
+    size_t len = 0;
+    char ch;
+    while (len < kTxChunkSize && mTxBuf.Get(ch)) {
+        mTxChunk[len++] = ch;
+    }
+
+    // Start a DMA transfer to send the characters to the UART; if there
+    // are no more characters to send, mark the transmitter idle.
+    if (len > 0) {
+        dma_channel_transfer_from_buffer_now(mTxDMAChan, mTxChunk, (uint32_t)len);
+        mTxActive = true;
+    }
+    else {
+        mTxActive = false;
+    }
+}
+
+void __not_in_flash_func(BufferedUART::HandleIRQ)(void)
+{
+    // Move all characters in the UART's receive FIFO into the receive buffer.
+    while (uart_is_readable(mUART)) {
+        uint32_t dr = uart_get_hw(mUART)->dr;
+
+        // Count any characters that were lost because the receive FIFO
+        // overflowed before the interrupt could be serviced.
+        if ((dr & UART_UARTDR_OE_BITS) != 0) {
+            mRxOverrunCount++;
+        }
+
+        // Count any characters that are lost because the receive buffer
+        // is full.
+        if (!mRxBuf.Put((char)(dr & 0xFF))) {
+            mRxOverrunCount++;
+        }
+    }
+}
+
+void __not_in_flash_func(BufferedUART::HandleUART0IRQ)(void)
+{
+    sInstances[0]->HandleIRQ();
+}
+
+void __not_in_flash_func(BufferedUART::HandleUART1IRQ)(void)
+{
+    sInstances[1]->HandleIRQ();
+}
+
+void __not_in_flash_func(BufferedUART::HandleDMAIRQ)(void)
+{
+    // For each UART whose DMA transfer has completed, start sending the
+    // next chunk of characters, if any.
+    for (auto inst : sInstances) {
+        if (inst != NULL && dma_channel_get_irq0_status(inst->mTxDMAChan)) {
+            dma_channel_acknowledge_irq0(inst->mTxDMAChan);
+            critical_section_enter_blocking(&inst->mTxLock);
+            inst->StartTx();
+            critical_section_exit(&inst->mTxLock);
+        }
+    }
+}
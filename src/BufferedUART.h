@@ -0,0 +1,110 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BUFFERED_UART_H
+#define BUFFERED_UART_H
+
+#include "pico/critical_section.h"
+
+#include "RingBuffer.h"
+
+/** Provides interrupt-driven buffering for a Pico UART
+ *
+ * Characters received by the UART are moved into a RAM ring buffer by an
+ * interrupt handler, so that they are not lost if the main loop is slow
+ * to read them.
+ *
+ * Characters written to the UART are placed in a transmit ring buffer and
+ * fed to the UART by DMA, so that writers do not wait for the characters
+ * to be sent.
+ *
+ * The interrupt handlers execute on whichever core called Init().  Writes
+ * may be made from either core, or from an interrupt handler.
+ */
+class BufferedUART final
+{
+public:
+    BufferedUART(void) = default;
+    ~BufferedUART(void) = default;
+
+    BufferedUART(const BufferedUART&) = delete;
+    BufferedUART& operator=(const BufferedUART&) = delete;
+
+    void Init(uart_inst_t * uart);
+    bool TryRead(char& ch);
+    size_t ReadSome(char * buf, size_t maxLen);
+    size_t RxCount(void) const;
+    uint32_t RxOverrunCount(void) const;
+    bool TryWrite(char ch);
+    bool WriteDropOldest(char ch);
+    void Write(char ch);
+    void Write(const char * str);
+    bool CanWrite(void) const;
+    size_t TxSpace(void) const;
+    void Flush(void);
+
+private:
+    static constexpr size_t kTxChunkSize = 32;
+
+    uart_inst_t * mUART;
+    RingBuffer<UART_RX_BUFFER_SIZE> mRxBuf;
+    volatile uint32_t mRxOverrunCount;
+    RingBuffer<UART_TX_BUFFER_SIZE> mTxBuf;
+    char mTxChunk[kTxChunkSize];
+    uint mTxDMAChan;
+    volatile bool mTxActive;
+    critical_section_t mTxLock;
+
+    void HandleIRQ(void);
+    void StartTx(void);
+
+    static BufferedUART * sInstances[NUM_UARTS];
+    static void HandleUART0IRQ(void);
+    static void HandleUART1IRQ(void);
+    static void HandleDMAIRQ(void);
+};
+
+inline bool BufferedUART::TryRead(char& ch)
+{
+    return mRxBuf.Get(ch);
+}
+
+inline size_t BufferedUART::ReadSome(char * buf, size_t maxLen)
+{
+    return mRxBuf.Get(buf, maxLen);
+}
+
+inline size_t BufferedUART::RxCount(void) const
+{
+    return mRxBuf.Count();
+}
+
+inline uint32_t BufferedUART::RxOverrunCount(void) const
+{
+    return mRxOverrunCount;
+}
+
+inline bool BufferedUART::CanWrite(void) const
+{
+    return !mTxBuf.IsFull();
+}
+
+inline size_t BufferedUART::TxSpace(void) const
+{
+    return mTxBuf.Space();
+}
+
+#endif // BUFFERED_UART_H
@@ -60,6 +60,110 @@
 #define AUX_TERM_UART_TX_PIN 8
 #define AUX_TERM_UART_RX_PIN 9
 
+// Enable dual-core operation.  In dual-core mode, core1 handles the SCL and AUX
+// UART interrupts, the READER RUN signal and the activity LEDs, and forwards
+// output from the PDP-11 to the AUX terminal and to core0 for the USB host,
+// while core0 runs the USB interface and the user interface.  This keeps the
+// paper tape reader running, and PDP-11 output flowing, while core0 is busy
+// (e.g. in a menu, or writing settings to flash).  Comment out DUAL_CORE_MODE
+// to run everything on core0.
+#define DUAL_CORE_MODE
+
+// Size of the buffer used to pass output from the PDP-11 from core1 to core0
+// for forwarding to the USB host in dual-core mode.  This holds the output
+// while core0 is busy, e.g. while the menu is displayed on the USB host.
+// NOTE: must be a power of 2
+#define SCL_HOST_OUTPUT_BUFFER_SIZE 16384
+
+// Size of the receive buffers for the SCL and AUX UARTs.  Characters received
+// by the UARTs are moved into these buffers by an interrupt handler, allowing
+// the main loop to stall for extended periods without losing data.
+// NOTE: must be a power of 2
+#define UART_RX_BUFFER_SIZE 4096
+
+// Size of the transmit buffers for the SCL and AUX UARTs.  Characters written
+// to the UARTs are queued in these buffers and fed to the UARTs by DMA.  When
+// forwarding output from the PDP-11, the AUX port's buffer absorbs bursts of
+// output that arrive faster than the auxiliary terminal can accept them.
+// NOTE: must be a power of 2
+#define UART_TX_BUFFER_SIZE 1024
+
+// Size of the transmit buffer for the host USB port.  Characters written to the
+// host are collected in this buffer and passed to the USB stack in batches.
+// NOTE: must be a power of 2
+#define HOST_TX_BUFFER_SIZE 2048
+
+// Maximum amount of time (in us) that output to the host USB port is held in
+// the transmit buffer waiting for more characters to be written.
+#define HOST_TX_FLUSH_DELAY_US 1000
+
+// Maximum amount of time (in us) to wait for the host to accept output before
+// discarding characters.
+#define HOST_TX_TIMEOUT_US 500000
+
+// Size of the buffer used to queue characters sent from the user to the PDP-11
+// when input pacing is enabled.
+// NOTE: must be a power of 2
+#define INPUT_PACER_BUFFER_SIZE 32768
+
+// Default amount of time (in ms) to wait for the PDP-11 to echo a character
+// when using echo-based input pacing.
+#define DEFAULT_ECHO_TIMEOUT_MS 250
+
+// Default inter-character delay, end-of-line delay (in ms) and burst size used
+// for fixed-rate input pacing.
+#define DEFAULT_PACE_CHAR_DELAY_MS 10
+#define DEFAULT_PACE_LINE_DELAY_MS 250
+#define DEFAULT_PACE_BURST_SIZE 1
+
+// Ranges of values accepted for the input pacing settings.  Stored settings
+// outside these ranges are replaced with the defaults when loaded.
+#define MIN_ECHO_TIMEOUT_MS 1
+#define MAX_ECHO_TIMEOUT_MS 10000
+#define MAX_PACE_DELAY_MS 10000
+#define MIN_PACE_BURST_SIZE 1
+#define MAX_PACE_BURST_SIZE 1024
+
+// Maximum number of characters of console output (echoed characters, line
+// feeds and prompts) that may be outstanding when pipelining commands to the
+// M9301/M9312 console during a load.  A value of 3 allows the first character
+// of the next command to be sent while the console is printing its prompt,
+// without risk of overrunning the PDP-11's single character receive buffer.
+// Set to 0 to issue commands in lock-step.
+#define M93XX_PIPELINE_WINDOW 3
+
+// Maximum number of 128-byte pages in the sparse memory image used to stage
+// files loaded via the M9301/M9312 console.  The default of 448 pages covers
+// the full 28 KW of memory addressable below the I/O page, so that any image
+// that fits in memory can be staged.  Files that would need more pages are
+// loaded directly from the file, and load queues that would need more pages
+// can't be run.
+#define MEMORY_IMAGE_MAX_PAGES 448
+
+// Minimum length (in words) of a run of zero words in a loaded image that is
+// cleared by a memory clear routine rather than deposited via the console, and
+// the maximum number of such runs cleared per load.
+#define ZERO_RUN_MIN_WORDS 16
+#define ZERO_RUN_MAX_RANGES 16
+
+// Default address at which the memory clear routine re-enters the M9301/M9312
+// console emulator once it has finished.  This is the console emulator entry
+// point of the M9312 23-248F1 ROM.  The address used can be changed in the
+// adapter settings to suit the console ROM in use.
+#define DEFAULT_CONSOLE_ENTRY_ADDR 0165020
+
+// Amount of time (in ms) to wait for the high-speed loader to signal that it
+// is ready after being started, and to reply to each frame once the frame has
+// been transmitted.  The reply timeout must allow for the time the loader
+// spends discarding input after rejecting a frame header (roughly one second
+// on an 11/05).
+#define HIGH_SPEED_LOADER_READY_TIMEOUT_MS 2000
+#define HIGH_SPEED_LOADER_REPLY_TIMEOUT_MS 2500
+
+// Number of times a frame is resent after being rejected by the high-speed
+// loader before the load is abandoned.
+#define HIGH_SPEED_LOADER_MAX_RETRIES 3
+
 // Minimum, maximum and default baud rates
 //
 // The SCL UART in the PDP-11/05 (e.g. an AY-5-1013) supports up to 40000 baud.
@@ -92,6 +196,17 @@
 // Input pin for "READER RUN +" signal from PDP-11/05 (F/06 on the SCL connector).
 #define READER_RUN_PIN 3
 
+// Deliver paper tape bytes to the PDP-11 directly from the READER RUN interrupt
+// handler.  This minimizes the latency between the PDP-11 requesting a byte and
+// the byte being sent, allowing tapes to be read at the full speed of the SCL
+// port.  Comment out READER_RUN_ISR_DELIVERY to deliver bytes from the main loop.
+#define READER_RUN_ISR_DELIVERY
+
+// Number of pending READER RUN requests for which the request time is retained,
+// for use in measuring the latency of paper tape reader deliveries.
+// NOTE: must be a power of 2
+#define SCL_READER_RUN_TIME_SLOTS 8
+
 // System Activity LED pin.
 #if HW_REV == 40
 #define SYS_ACTIVITY_LED_PIN 14
@@ -128,12 +243,26 @@
 // Maximum file name length
 #define MAX_FILE_NAME_LEN 32
 
+// Maximum number of files in the load queue
+#define LOAD_QUEUE_MAX_FILES 8
+
+// Maximum number of data blocks in an LDA file that can be loaded in order
+// of increasing address.  Files with more blocks are loaded in file order.
+#define LDA_MAX_ORDERED_BLOCKS 64
+
 // Input character to invoke the menu mode while in terminal mode
 #define MENU_KEY '\036' // Ctrl+^
 
 // Maximum size of an uploaded file
 #define MAX_UPLOAD_FILE_SIZE (64*1024)
 
+// Amount of time (in ms) to wait for the receiver to start an XMODEM file
+// download, and to acknowledge each block, as well as the number of times a
+// block is resent before the download is abandoned.
+#define XMODEM_SEND_START_TIMEOUT_MS 60000
+#define XMODEM_SEND_REPLY_TIMEOUT_MS 10000
+#define XMODEM_SEND_MAX_RETRIES 10
+
 // Width of the paper tape reader progress bar
 #define PROGRESS_BAR_WIDTH 20
 
@@ -37,11 +37,20 @@ public:
     virtual ~Port(void) = default;
     virtual char Read(void) = 0;
     virtual bool TryRead(char &ch) = 0;
+    virtual size_t ReadSome(char * buf, size_t maxLen);
     virtual void Write(char ch) = 0;
     virtual void Write(const char * str) = 0;
     virtual bool CanWrite(void) = 0;
     virtual void Flush(void) = 0;
     int Printf(const char* format, ...);
+
+    // Action to take when forwarding a character to a port whose
+    // output buffer is full
+    enum OverflowPolicy_t : uint8_t {
+        OverflowPolicy_Block,
+        OverflowPolicy_DropOldest,
+        OverflowPolicy_DropNewest
+    };
 };
 
 struct SerialConfig final
@@ -61,6 +70,12 @@ struct SerialConfig final
                Parity == other.Parity;
     }
     bool operator!=(const SerialConfig& other) const { return !(*this == other); }
+
+    // Time to transmit one character, including start, parity and stop bits
+    uint32_t CharTimeUS(void) const {
+        uint32_t charBits = 1U + DataBits + ((Parity != PARITY_NONE) ? 1U : 0U) + StopBits;
+        return (charBits * 1000000 + BitRate - 1) / BitRate;
+    }
 };
 
 class LoadDataSource
@@ -72,18 +87,64 @@ public:
     virtual void Advance(void) = 0;
     virtual bool AtEnd(void) = 0;
     virtual uint16_t GetStartAddress(void) = 0;
+    virtual void Rewind(void) = 0;
+    virtual bool GetRun(uint16_t& addr, const uint8_t *& data, size_t& len);
+    virtual void AdvanceRun(size_t len);
+
+private:
+    uint8_t mRunBuf[2];
 };
 
+// Get the run of consecutive words starting at the current position, as the
+// run's load address, a pointer to its data in PDP-11 (little-endian) byte
+// order and its length in bytes.  If the length is odd, the high byte of the
+// last word is zero.  Data sources that hold their data in memory override
+// this to return whole runs; by default, a run consists of a single word.
+inline bool LoadDataSource::GetRun(uint16_t& addr, const uint8_t *& data, size_t& len)
+{
+    uint16_t word;
+    if (!GetWord(word, addr)) {
+        return false;
+    }
+    mRunBuf[0] = (uint8_t)word;
+    mRunBuf[1] = (uint8_t)(word >> 8);
+    data = mRunBuf;
+    len = sizeof(mRunBuf);
+    return true;
+}
+
+// Advance past the given number of bytes (rounded up to a whole number of
+// words) of the current run.
+inline void LoadDataSource::AdvanceRun(size_t len)
+{
+    for (size_t i = 0; i < len; i += 2) {
+        Advance();
+    }
+}
+
 // ================================================================================
 // MAJOR MODE FUNCTIONS
 // ================================================================================
 
 extern void TerminalMode(void);
 extern void MenuMode(Port& uiPort);
-extern void LoadFileMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName);
+extern bool LoadFileMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName);
+extern bool ResumeLoadFileMode(Port& uiPort);
+extern bool CanResumeLoad(void);
+extern void BeginBatchLoad(void);
+extern bool AddToBatchLoad(LoadDataSource& fileSrc);
+extern uint32_t BatchLoadWordCount(void);
+extern uint16_t BatchLoadStartAddress(void);
+extern bool BatchLoadMode(Port& uiPort, const char * batchName, uint16_t startAddr);
+extern uint32_t EstimateLoadTimeMS(LoadDataSource& dataSrc, uint32_t& cmdCount, uint32_t& charCount);
+extern uint32_t EstimateVerifyTimeMS(LoadDataSource& dataSrc);
+extern bool HighSpeedLoadMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName);
+extern bool DumpMemoryMode(Port& uiPort, uint16_t startAddr, size_t wordCount, uint8_t * buf);
+extern bool ProbeMemoryMode(Port& uiPort, uint32_t& memSizeKW);
 extern void DiagMode_BasicIOTest(Port& uiPort);
 extern void DiagMode_ReaderRunTest(Port& uiPort);
 extern void DiagMode_SettingsTest(Port& uiPort);
+extern void DiagMode_TapeReaderStats(Port& uiPort);
 
 // ================================================================================
 // UTILITY FUNCTIONS
@@ -91,8 +152,10 @@ extern void DiagMode_SettingsTest(Port& uiPort);
 
 extern bool TryReadHostAuxPorts(char& ch);
 extern bool TryReadHostAuxPorts(char& ch, Port *& port);
+extern size_t ReadSomeHostAuxPorts(char * buf, size_t maxLen, Port *& port);
 extern void WriteHostAuxPorts(char ch);
 extern void WriteHostAuxPorts(const char* str);
+extern void ForwardHostAuxPorts(char ch);
 
 // ================================================================================
 // GENERAL CONSTANTS
@@ -111,6 +174,7 @@ constexpr static char CAN = '\x18';
 // ================================================================================
 
 #include "ActivityLED.h"
+#include "BufferedUART.h"
 #include "HostPort.h"
 #include "SCLPort.h"
 #include "AuxPort.h"
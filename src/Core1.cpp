@@ -0,0 +1,182 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConsoleAdapter.h"
+#include "Core1.h"
+#include "Settings.h"
+
+#include "pico/multicore.h"
+#include "hardware/irq.h"
+
+void (*volatile Core1::sInitFunc)(void);
+volatile bool Core1::sStarted;
+volatile bool Core1::sFlashOpRequested;
+volatile bool Core1::sFlashOpAcked;
+volatile bool Core1::sForwardSuspendRequested;
+volatile bool Core1::sForwardSuspendAcked;
+uint32_t Core1::sForwardSuspendCount;
+RingBuffer<SCL_HOST_OUTPUT_BUFFER_SIZE> Core1::sHostOutputBuf;
+volatile uint32_t Core1::sHostOutputDroppedCount;
+
+void Core1::Start(void (*initFunc)(void))
+{
+    sInitFunc = initFunc;
+
+    multicore_launch_core1(Main);
+
+    // Wait for core1 to complete initialization.
+    while (!sStarted) {
+        tight_loop_contents();
+    }
+}
+
+void Core1::BeginFlashOperation(void)
+{
+    // Ask core1 to stop executing code from flash and wait for it to
+    // acknowledge.  While the flash operation is in progress, core1
+    // continues to service the UART and DMA interrupts, whose handlers
+    // reside in RAM.
+    if (sStarted) {
+        sFlashOpRequested = true;
+        while (!sFlashOpAcked) {
+            tight_loop_contents();
+        }
+    }
+}
+
+void Core1::EndFlashOperation(void)
+{
+    // Release core1 and wait for it to resume normal operation.
+    if (sStarted) {
+        sFlashOpRequested = false;
+        while (sFlashOpAcked) {
+            tight_loop_contents();
+        }
+    }
+}
+
+void Core1::SuspendForwarding(void)
+{
+    // Ask core1 to stop forwarding output from the PDP-11 and wait for it to
+    // acknowledge, so that the caller can read the SCL port itself.  Calls
+    // nest; forwarding resumes once each call has been matched by a call to
+    // ResumeForwarding().
+    if (sStarted && sForwardSuspendCount++ == 0) {
+        sForwardSuspendRequested = true;
+        while (!sForwardSuspendAcked) {
+            tight_loop_contents();
+        }
+
+        // Forward any output already queued for the USB host, so that it
+        // appears ahead of anything written by the caller.
+        char ch;
+        while (sHostOutputBuf.Get(ch)) {
+            gHostPort.Forward(ch, Settings::HostOverflowPolicy);
+        }
+    }
+}
+
+void Core1::ResumeForwarding(void)
+{
+    // Release core1 and wait for it to resume forwarding.
+    if (sStarted && sForwardSuspendCount > 0 && --sForwardSuspendCount == 0) {
+        sForwardSuspendRequested = false;
+        while (sForwardSuspendAcked) {
+            tight_loop_contents();
+        }
+    }
+}
+
+void Core1::Main(void)
+{
+    // Perform initialization on core1, so that the interrupts for the
+    // SCL and AUX ports are enabled, and handled, on this core.
+    sInitFunc();
+
+    sStarted = true;
+
+    while (true) {
+
+        // If core0 is about to modify flash, switch to executing from RAM
+        // until it is done.  The READER RUN interrupt is disabled during
+        // this time because its handler resides in flash.
+        if (sFlashOpRequested) {
+            irq_set_enabled(IO_IRQ_BANK0, false);
+            WaitForFlashOperation();
+            irq_set_enabled(IO_IRQ_BANK0, true);
+        }
+
+        // Deliver a byte from the paper tape reader if the PDP-11 has
+        // requested one.
+        PaperTapeReader::ServiceReaderRun();
+
+        // Forward output from the PDP-11, unless core0 has suspended
+        // forwarding.
+        if (sForwardSuspendRequested) {
+            sForwardSuspendAcked = true;
+        }
+        else {
+            sForwardSuspendAcked = false;
+            ForwardSCLOutput();
+        }
+
+        // Update the state of the activity LEDs
+        ActivityLED::UpdateState();
+    }
+}
+
+void Core1::ForwardSCLOutput(void)
+{
+    char buf[32];
+    size_t maxLen = sizeof(buf);
+
+    // Read as many characters from the SCL port as can be forwarded without
+    // waiting.  If the overflow policy for a port is to block, characters
+    // that the port has no room for are left in the SCL port's receive
+    // buffer, so that core1 itself is never held up by a slow port.
+    if (Settings::HostOverflowPolicy == Port::OverflowPolicy_Block) {
+        maxLen = MIN(maxLen, sHostOutputBuf.Space());
+    }
+#if defined(AUX_TERM_UART)
+    if (Settings::AuxOverflowPolicy == Port::OverflowPolicy_Block) {
+        maxLen = MIN(maxLen, gAuxPort.WriteSpace());
+    }
+#endif
+    size_t len = gSCLPort.ReadSome(buf, maxLen);
+
+    for (size_t i = 0; i < len; i++) {
+
+        // Queue the character for core0 to forward to the USB host.  If core0
+        // has fallen so far behind that the queue is full, drop the character.
+        if (!sHostOutputBuf.Put(buf[i])) {
+            sHostOutputDroppedCount = sHostOutputDroppedCount + 1;
+        }
+
+#if defined(AUX_TERM_UART)
+        // Forward the character to the Aux port.
+        gAuxPort.Forward(buf[i], Settings::AuxOverflowPolicy);
+#endif
+    }
+}
+
+void __not_in_flash_func(Core1::WaitForFlashOperation)(void)
+{
+    sFlashOpAcked = true;
+    while (sFlashOpRequested) {
+        tight_loop_contents();
+    }
+    sFlashOpAcked = false;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CORE1_H
+#define CORE1_H
+
+/** Manages the real-time functions that run on the RP2040's second core
+ *
+ * In dual-core mode, core1 owns the SCL and AUX UART interrupts, the
+ * READER RUN signal and the activity LEDs.  Core1 also forwards output
+ * from the PDP-11 to the AUX port, and queues it for core0 to forward to
+ * the USB host, so that the output keeps flowing while core0 is busy.
+ * Core0 runs the USB interface and the user interface, and exchanges
+ * characters with core1 via lock-free ring buffers.
+ *
+ * Code on core0 that reads the SCL port itself (e.g. to talk to the
+ * M9301/M9312 console) must suspend forwarding while it does so.
+ */
+class Core1 final
+{
+public:
+    static void Start(void (*initFunc)(void));
+    static void BeginFlashOperation(void);
+    static void EndFlashOperation(void);
+    static void SuspendForwarding(void);
+    static void ResumeForwarding(void);
+    static size_t ReadHostOutput(char * buf, size_t maxLen);
+    static uint32_t HostOutputDroppedCount(void);
+
+private:
+    static void (*volatile sInitFunc)(void);
+    static volatile bool sStarted;
+    static volatile bool sFlashOpRequested;
+    static volatile bool sFlashOpAcked;
+    static volatile bool sForwardSuspendRequested;
+    static volatile bool sForwardSuspendAcked;
+    static uint32_t sForwardSuspendCount;
+    static RingBuffer<SCL_HOST_OUTPUT_BUFFER_SIZE> sHostOutputBuf;
+    static volatile uint32_t sHostOutputDroppedCount;
+
+    static void Main(void);
+    static void WaitForFlashOperation(void);
+    static void ForwardSCLOutput(void);
+};
+
+inline size_t Core1::ReadHostOutput(char * buf, size_t maxLen)
+{
+    return sHostOutputBuf.Get(buf, maxLen);
+}
+
+inline uint32_t Core1::HostOutputDroppedCount(void)
+{
+    return sHostOutputDroppedCount;
+}
+
+#endif // CORE1_H
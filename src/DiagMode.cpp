@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 
+#include <inttypes.h>
+
 #include "ConsoleAdapter.h"
 #include "Settings.h"
 #include "Menu.h"
+#include "Core1.h"
 
 void DiagMode_BasicIOTest(Port& uiPort)
 {
@@ -48,6 +51,9 @@ void DiagMode_BasicIOTest(Port& uiPort)
         "\r\n"
     );
 
+    // Keep core1 from forwarding the echoed characters, which are checked here.
+    Core1::SuspendForwarding();
+
     while (true) {
         bool updateStatus = false;
 
@@ -93,6 +99,8 @@ void DiagMode_BasicIOTest(Port& uiPort)
                 lastSent, lastRcvd, mismatchCount);
         }
     }
+
+    Core1::ResumeForwarding();
 }
 
 void DiagMode_ReaderRunTest(Port& uiPort)
@@ -103,6 +111,13 @@ void DiagMode_ReaderRunTest(Port& uiPort)
     uint8_t pdp11RRCount = 0;
     bool paused = false;
 
+    // The test answers READER RUN requests itself, and so would compete with
+    // the paper tape reader for them if a tape were mounted.
+    if (PaperTapeReader::IsMounted()) {
+        uiPort.Write(TITLE_PREFIX "READER RUN TEST NOT POSSIBLE (unmount paper tape first)\r\n");
+        return;
+    }
+
     uiPort.Write(
         TITLE_PREFIX "READER RUN INTERFACE TEST\r\n"
         "\r\n"
@@ -129,6 +144,9 @@ void DiagMode_ReaderRunTest(Port& uiPort)
         "\r\n"
     );
 
+    // Keep core1 from forwarding the counts sent by the PDP-11.
+    Core1::SuspendForwarding();
+
     while (true) {
         bool updateStatus = false;
 
@@ -159,7 +177,7 @@ void DiagMode_ReaderRunTest(Port& uiPort)
         }
 
         if (gSCLPort.ReaderRunRequested() && !paused) {
-            gSCLPort.ClearReaderRunRequested();
+            gSCLPort.ConsumeReaderRunRequest();
             localRRCount++;
             gSCLPort.Write('.');
             updateStatus = true;
@@ -175,6 +193,8 @@ void DiagMode_ReaderRunTest(Port& uiPort)
                 (mismatch) ? "[MISMATCH]" : "          ");
         }
     }
+
+    Core1::ResumeForwarding();
 }
 
 extern "C" uint8_t __SettingsStorageStart;
@@ -217,4 +237,30 @@ void DiagMode_SettingsTest(Port& uiPort)
             return;
         }
     }
-}
\ No newline at end of file
+}
+
+void DiagMode_TapeReaderStats(Port& uiPort)
+{
+    PaperTapeReader::Stats stats;
+
+    PaperTapeReader::GetStats(stats);
+
+    uiPort.Write(TITLE_PREFIX "TAPE READER STATS:\r\n");
+    if (PaperTapeReader::IsMounted()) {
+        uiPort.Printf("  Tape: %s\r\n", PaperTapeReader::TapeName());
+    }
+    PaperTapeReader::PrintStats(uiPort, "  ");
+    uiPort.Printf("  READER RUN requests pending: %" PRIu32 "\r\n", gSCLPort.PendingReaderRunRequests());
+
+    // Display the request latency histogram
+    uiPort.Write("  Queued latency histogram (request to byte queued):\r\n");
+    uint32_t limit = 10;
+    for (size_t i = 0; i < PaperTapeReader::kLatencyBuckets; i++, limit *= 10) {
+        if (i < PaperTapeReader::kLatencyBuckets - 1) {
+            uiPort.Printf("    < %7" PRIu32 " us: %" PRIu32 "\r\n", limit, stats.LatencyHist[i]);
+        }
+        else {
+            uiPort.Printf("    >=%7" PRIu32 " us: %" PRIu32 "\r\n", limit / 10, stats.LatencyHist[i]);
+        }
+    }
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "ConsoleAdapter.h"
+#include "DownloadFileMode.h"
+
+// XMODEM protocol characters
+constexpr static char kSOH = '\x01';
+constexpr static char kEOT = '\x04';
+constexpr static char kACK = '\x06';
+constexpr static char kNAK = '\x15';
+constexpr static char kCRCMode = 'C';
+constexpr static uint8_t kPad = 0x1A;
+
+constexpr static size_t kBlockDataLen = 128;
+
+static uint16_t UpdateCRC16(uint16_t crc, uint8_t byte);
+
+// Send a file to the host using the XMODEM protocol, with either CRC-16 or
+// checksum error detection as requested by the receiver.  The file's bytes
+// are read from the given image as each block is built, so the file need not
+// exist in memory in its final form.
+bool DownloadFileMode(Port& uiPort, const TapeImage& file)
+{
+    enum {
+        kWaitStart,
+        kSendBlock,
+        kWaitReply,
+        kSendEOT,
+        kWaitEOTReply,
+        kDone
+    } state = kWaitStart;
+    size_t fileLen = file.Length();
+    size_t blockPos = 0;
+    uint8_t blockNum = 1;
+    bool useCRC = false;
+    bool succeeded = false;
+    const char * failReason = "Communication error";
+    uint32_t retryCount = 0;
+    uint64_t timeoutTime = time_us_64() + XMODEM_SEND_START_TIMEOUT_MS * 1000;
+    char ch;
+
+    uiPort.Write(TITLE_PREFIX "AWAITING FILE DOWNLOAD\r\n");
+
+    while (state != kDone) {
+
+        // Update the state of the activity LEDs
+        ActivityLED::UpdateState();
+
+        // If the receiver fails to respond in time, retry the last block
+        // (or EOT), or give up once the retries are exhausted.
+        if (time_us_64() > timeoutTime) {
+            if (state == kWaitStart || retryCount++ == XMODEM_SEND_MAX_RETRIES) {
+                failReason = "Timeout";
+                break;
+            }
+            state = (state == kWaitEOTReply) ? kSendEOT : kSendBlock;
+        }
+
+        switch (state) {
+        case kWaitStart:
+
+            // Wait for the receiver to request the start of the transfer,
+            // using a 'C' to select CRC mode or a NAK to select checksum
+            // mode.  Allow the user to abort by sending a Ctrl+C.
+            if (uiPort.TryRead(ch)) {
+                if (ch == kCRCMode || ch == kNAK) {
+                    useCRC = (ch == kCRCMode);
+                    state = kSendBlock;
+                }
+                else if (ch == CTRL_C || ch == CAN) {
+                    uiPort.Write(TITLE_PREFIX "FILE DOWNLOAD ABORTED\r\n");
+                    return false;
+                }
+            }
+            break;
+
+        case kSendBlock:
+        {
+            // Send the next block of the file, padding the final block as
+            // needed.
+            uint8_t sum = 0;
+            uint16_t crc = 0;
+            uiPort.Write(kSOH);
+            uiPort.Write((char)blockNum);
+            uiPort.Write((char)~blockNum);
+            for (size_t i = 0; i < kBlockDataLen; i++) {
+                uint8_t byte = (blockPos + i < fileLen) ? file.ReadByte(blockPos + i) : kPad;
+                uiPort.Write((char)byte);
+                sum = (uint8_t)(sum + byte);
+                crc = UpdateCRC16(crc, byte);
+            }
+            if (useCRC) {
+                uiPort.Write((char)(crc >> 8));
+                uiPort.Write((char)crc);
+            }
+            else {
+                uiPort.Write((char)sum);
+            }
+            timeoutTime = time_us_64() + XMODEM_SEND_REPLY_TIMEOUT_MS * 1000;
+            state = kWaitReply;
+            break;
+        }
+
+        case kWaitReply:
+
+            // On an ACK, move to the next block, or finish the transfer once
+            // the whole file has been sent.  On a NAK, resend the block.
+            if (uiPort.TryRead(ch)) {
+                if (ch == kACK) {
+                    blockPos += kBlockDataLen;
+                    blockNum++;
+                    retryCount = 0;
+                    state = (blockPos < fileLen) ? kSendBlock : kSendEOT;
+                }
+                else if (ch == kNAK) {
+                    if (retryCount++ == XMODEM_SEND_MAX_RETRIES) {
+                        state = kDone;
+                        break;
+                    }
+                    state = kSendBlock;
+                }
+                else if (ch == CAN) {
+                    failReason = "Cancelled by receiver";
+                    state = kDone;
+                }
+            }
+            break;
+
+        case kSendEOT:
+            uiPort.Write(kEOT);
+            timeoutTime = time_us_64() + XMODEM_SEND_REPLY_TIMEOUT_MS * 1000;
+            state = kWaitEOTReply;
+            break;
+
+        case kWaitEOTReply:
+            if (uiPort.TryRead(ch)) {
+                if (ch == kACK) {
+                    succeeded = true;
+                    state = kDone;
+                }
+                else if (ch == kNAK) {
+                    if (retryCount++ == XMODEM_SEND_MAX_RETRIES) {
+                        state = kDone;
+                        break;
+                    }
+                    state = kSendEOT;
+                }
+            }
+            break;
+
+        case kDone:
+            break;
+        }
+    }
+
+    // If the transfer failed, tell the receiver to abort.
+    if (!succeeded) {
+        uiPort.Write(CAN);
+        uiPort.Write(CAN);
+    }
+
+    // Give the receiver's transfer program some time to finish
+    // During this time, discard any extraneous characters from the receiver
+    {
+        char rxBuf[64];
+        uint64_t waitEndTime = time_us_64() + 250000;
+        while (time_us_64() < waitEndTime) {
+            ActivityLED::UpdateState();
+            uiPort.ReadSome(rxBuf, sizeof(rxBuf));
+        }
+    }
+
+    if (!succeeded) {
+        uiPort.Printf(TITLE_PREFIX "FILE DOWNLOAD FAILED: %s\r\n", failReason);
+        return false;
+    }
+
+    uiPort.Printf(TITLE_PREFIX "FILE DOWNLOAD COMPLETE (%zu bytes)\r\n", fileLen);
+    return true;
+}
+
+uint16_t UpdateCRC16(uint16_t crc, uint8_t byte)
+{
+    // CRC-16/XMODEM (polynomial 0x1021, initial value 0)
+    crc = (uint16_t)(crc ^ ((uint16_t)byte << 8));
+    for (int i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
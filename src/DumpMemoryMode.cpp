@@ -0,0 +1,152 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <inttypes.h>
+
+#include "ConsoleAdapter.h"
+#include "M93xxController.h"
+#include "Core1.h"
+
+// Interval at which dump progress is reported.
+constexpr static uint64_t kProgressIntervalUS = 1000 * 1000;
+
+static void ReportProgress(Port& uiPort, size_t wordsDumped, size_t wordCount, uint64_t elapsedUS);
+
+bool DumpMemoryMode(Port& uiPort, uint16_t startAddr, size_t wordCount, uint8_t * buf)
+{
+    M93xxController m93xxCtr;
+    size_t wordsDumped = 0;
+    bool examinePending = false;
+    bool dumpComplete = false;
+    uint64_t startTime = time_us_64();
+    uint64_t nextProgressTime = startTime + kProgressIntervalUS;
+
+    // Keep core1 from forwarding the console's output while it is read here.
+    Core1::SuspendForwarding();
+
+    // Scale the console timeouts to the current SCL baud rate.
+    m93xxCtr.SetCharTime(gSCLPort.GetConfig().CharTimeUS());
+
+    // Tell the user roughly how long the dump will take at the current SCL
+    // baud rate.
+    uint64_t estTimeUS = (uint64_t)wordCount * M93xxController::kExamineOutputLen * gSCLPort.GetConfig().CharTimeUS();
+    uiPort.Printf(TITLE_PREFIX "DUMPING %zu WORDS FROM %06" PRIo16 " (about %" PRIu32 " seconds)\r\n",
+                  wordCount, startAddr, (uint32_t)((estTimeUS + 999999) / 1000000));
+
+    while (true) {
+        char ch;
+        uint16_t addr;
+
+        // Update the state of the activity LEDs
+        ActivityLED::UpdateState();
+
+        // Update the connection status of the SCL port
+        gSCLPort.CheckConnected();
+
+        // Process any timeouts while talking to the M9301/M9312 console;
+        // If the console is unresponsive, abort.
+        if (m93xxCtr.ProcessTimeouts()) {
+            uiPort.Write("\r\n" TITLE_PREFIX "TIMEOUT (no response from console)\r\n");
+            break;
+        }
+
+        // Check for an interrupt character from the UI port.
+        if (uiPort.TryRead(ch) && ch == CTRL_C) {
+            uiPort.Write("\r\n" TITLE_PREFIX "INTERRUPTED\r\n");
+            break;
+        }
+
+        // Pass any output from the M9301/M9312 console to the M93xxController
+        // for processing.  The console output is not echoed, since the
+        // progress report takes its place.
+        if (gSCLPort.TryRead(ch) && !m93xxCtr.ProcessOutput(ch)) {
+            uiPort.Write("\r\n" TITLE_PREFIX "ERROR (unexpected response from console)\r\n");
+            break;
+        }
+
+        // Wait until the M9301/M9312 is ready for another command.
+        if (!m93xxCtr.IsReadyForCommand()) {
+            continue;
+        }
+
+        // If an examine command has completed, store the value read into
+        // the dump buffer.  Fail if the console didn't examine the expected
+        // address (e.g. because the address doesn't exist).
+        if (examinePending) {
+            examinePending = false;
+            addr = (uint16_t)(startAddr + wordsDumped * 2);
+            if (m93xxCtr.LastCommand() != 'E' || m93xxCtr.LastAddress() != addr) {
+                uiPort.Printf("\r\n" TITLE_PREFIX "ERROR (failed to examine %06" PRIo16 ")\r\n", addr);
+                break;
+            }
+            buf[wordsDumped * 2] = (uint8_t)m93xxCtr.LastExamineValue();
+            buf[wordsDumped * 2 + 1] = (uint8_t)(m93xxCtr.LastExamineValue() >> 8);
+            wordsDumped++;
+        }
+
+        // Periodically report progress.
+        if (time_us_64() >= nextProgressTime || wordsDumped == wordCount) {
+            ReportProgress(uiPort, wordsDumped, wordCount, time_us_64() - startTime);
+            nextProgressTime = time_us_64() + kProgressIntervalUS;
+        }
+
+        // Once all words have been read, the dump is complete.
+        if (wordsDumped == wordCount) {
+            uiPort.Write("\r\n");
+            dumpComplete = true;
+            break;
+        }
+
+        // If the console's next examine address is not the address of the
+        // next word, issue a set address (L) command; otherwise examine the
+        // word, letting the console auto-increment the address.
+        addr = (uint16_t)(startAddr + wordsDumped * 2);
+        if (m93xxCtr.NextExamineAddress() != addr) {
+            m93xxCtr.SetAddress(addr);
+            continue;
+        }
+        m93xxCtr.Examine();
+        examinePending = true;
+    }
+
+    // Report any errors in the console's output that were recovered from.
+    if (m93xxCtr.ErrorCount() > 0) {
+        uiPort.Printf(TITLE_PREFIX "CONSOLE ERRORS: %" PRIu32 " (recovered by resynchronizing %" PRIu32 " times)\r\n",
+                      m93xxCtr.ErrorCount(), m93xxCtr.RecoveryCount());
+    }
+
+    Core1::ResumeForwarding();
+
+    return dumpComplete;
+}
+
+void ReportProgress(Port& uiPort, size_t wordsDumped, size_t wordCount, uint64_t elapsedUS)
+{
+    uint32_t wordsPerSec = (elapsedUS > 0) ? (uint32_t)(((uint64_t)wordsDumped * 1000000) / elapsedUS) : 0;
+
+    // Overwrite the previous progress report, estimating the time remaining
+    // from the rate achieved so far.
+    uiPort.Printf("\r" TITLE_PREFIX "%zu/%zu words (%" PRIu32 "%%), %" PRIu32 " words/sec",
+                  wordsDumped, wordCount, (uint32_t)((wordsDumped * 100) / wordCount), wordsPerSec);
+    if (wordsPerSec > 0 && wordsDumped < wordCount) {
+        uiPort.Printf(", %" PRIu32 " sec remaining  ",
+                      (uint32_t)((wordCount - wordsDumped + wordsPerSec - 1) / wordsPerSec));
+    }
+    else {
+        uiPort.Write("                  ");
+    }
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+
+#include "ConsoleAdapter.h"
+#include "HighSpeedLoader.h"
+#include "BinaryLDATape.h"
+#include "Core1.h"
+
+// Maximum number of data bytes sent in a single frame.  This must not exceed
+// the limit enforced by the high-speed loader (512).
+constexpr static size_t kMaxFrameDataLen = 512;
+
+// Frame header (address, count and header checksum) and trailer (checksum)
+// lengths.
+constexpr static size_t kFrameHeaderLen = 5;
+constexpr static size_t kFrameTrailerLen = 1;
+
+static size_t BuildFrame(LoadDataSource& dataSrc, uint8_t * frameBuf, size_t& dataLen);
+static size_t BuildEndFrame(uint16_t startAddr, uint8_t * frameBuf);
+
+bool HighSpeedLoadMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName)
+{
+    enum {
+        kWaitReady,
+        kSendFrame,
+        kWaitReply,
+        kDone
+    } state = kWaitReady;
+    static uint8_t sFrameBuf[kFrameHeaderLen + kMaxFrameDataLen + kFrameTrailerLen];
+    size_t frameLen = 0, framePos = 0, frameDataLen = 0;
+    uint32_t retryCount = 0;
+    uint32_t totalBytes = 0;
+    uint32_t frameCount = 0;
+    bool endFrameSent = false;
+    bool loadComplete = false;
+    uint32_t charTimeUS = gSCLPort.GetConfig().CharTimeUS();
+    uint64_t startTime = time_us_64();
+    uint64_t timeoutTime = startTime + HIGH_SPEED_LOADER_READY_TIMEOUT_MS * 1000;
+
+    // Keep core1 from forwarding the loader's replies, which are read here.
+    Core1::SuspendForwarding();
+
+    uiPort.Printf(TITLE_PREFIX "STREAMING FILE: %s\r\n", fileName);
+
+    dataSrc.Rewind();
+
+    while (state != kDone) {
+        char ch;
+
+        // Update the state of the activity LEDs
+        ActivityLED::UpdateState();
+
+        // Update the connection status of the SCL port
+        gSCLPort.CheckConnected();
+
+        // Check for an interrupt character from the UI port.
+        if (uiPort.TryRead(ch) && ch == CTRL_C) {
+            uiPort.Write(TITLE_PREFIX "INTERRUPTED\r\n");
+            break;
+        }
+
+        // If the loader fails to respond in time, abort.
+        if ((state == kWaitReady || state == kWaitReply) && time_us_64() > timeoutTime) {
+            uiPort.Write(TITLE_PREFIX "TIMEOUT (no response from high-speed loader)\r\n");
+            break;
+        }
+
+        switch (state) {
+        case kWaitReady:
+
+            // Wait for the loader to signal that it is running, ignoring
+            // any remaining output from the M9301/M9312 console (e.g. the
+            // echo of the start command).
+            if (gSCLPort.TryRead(ch)) {
+                if (ch == HighSpeedLoaderDataSource::kFrameAck) {
+                    startTime = time_us_64();
+                    state = kSendFrame;
+                }
+                else {
+                    WriteHostAuxPorts(ch);
+                }
+            }
+            break;
+
+        case kSendFrame:
+
+            // If starting a new frame, build it from the next run of
+            // contiguous words in the data source; once all words have been
+            // sent, build the end frame.
+            if (framePos == 0 && retryCount == 0) {
+                frameLen = BuildFrame(dataSrc, sFrameBuf, frameDataLen);
+                if (frameLen == 0) {
+                    frameLen = BuildEndFrame(dataSrc.GetStartAddress(), sFrameBuf);
+                    frameDataLen = 0;
+                    endFrameSent = true;
+                }
+            }
+
+            // Feed the frame to the SCL port as fast as the port will accept it.
+            while (framePos < frameLen && gSCLPort.TryWrite((char)sFrameBuf[framePos])) {
+                framePos++;
+            }
+
+            // Once the whole frame is queued, wait for the loader's reply,
+            // allowing time for the frame to be transmitted.
+            if (framePos == frameLen) {
+                timeoutTime = time_us_64() + (uint64_t)frameLen * charTimeUS +
+                              HIGH_SPEED_LOADER_REPLY_TIMEOUT_MS * 1000;
+                state = kWaitReply;
+            }
+            break;
+
+        case kWaitReply:
+
+            if (!gSCLPort.TryRead(ch)) {
+                break;
+            }
+
+            // If the frame was accepted, move on to the next frame, or finish
+            // if the end frame has been sent.
+            if (ch == HighSpeedLoaderDataSource::kFrameAck) {
+                if (frameDataLen > 0) {
+                    totalBytes += frameDataLen;
+                    frameCount++;
+                }
+                retryCount = 0;
+                framePos = 0;
+                if (endFrameSent) {
+                    loadComplete = true;
+                    state = kDone;
+                }
+                else {
+                    state = kSendFrame;
+                }
+            }
+
+            // If the loader reports a checksum error, resend the frame, up to
+            // a limit.
+            else if (ch == HighSpeedLoaderDataSource::kFrameNak) {
+                if (++retryCount > HIGH_SPEED_LOADER_MAX_RETRIES) {
+                    uiPort.Write(TITLE_PREFIX "ERROR (high-speed loader rejected frame)\r\n");
+                    state = kDone;
+                }
+                else {
+                    framePos = 0;
+                    state = kSendFrame;
+                }
+            }
+
+            // Any other character indicates the loader is not running.
+            else {
+                uiPort.Write(TITLE_PREFIX "ERROR (unexpected response from high-speed loader)\r\n");
+                state = kDone;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    Core1::ResumeForwarding();
+
+    if (loadComplete) {
+        uint64_t elapsedUS = time_us_64() - startTime;
+        uint32_t wordCount = (totalBytes + 1) / 2;
+        uint32_t cmdCount, charCount;
+
+        // Report the achieved load rate alongside the rates for depositing
+        // the same data via the console and loading it from an LDA format
+        // paper tape.  The latter are computed from the load time estimates
+        // and are labeled as such, since they have not been measured.
+        uint32_t depositTimeMS = EstimateLoadTimeMS(dataSrc, cmdCount, charCount);
+        uint32_t tapeTimeMS = (uint32_t)(((uint64_t)BinaryLDATape::TapeLength(totalBytes) * charTimeUS) / 1000);
+        uiPort.Printf(TITLE_PREFIX "LOAD COMPLETE: %" PRIu32 " words in %" PRIu32 " frames, %" PRIu32 " ms (%" PRIu32 " words/sec)\r\n",
+                      wordCount, frameCount, (uint32_t)(elapsedUS / 1000),
+                      (uint32_t)((uint64_t)wordCount * 1000000 / MAX(elapsedUS, (uint64_t)1)));
+        uiPort.Printf(TITLE_PREFIX "ESTIMATED RATES (not measured): console deposit %" PRIu32 " words/sec, LDA paper tape %" PRIu32 " words/sec\r\n",
+                      (uint32_t)((uint64_t)wordCount * 1000 / MAX(depositTimeMS, 1U)),
+                      (uint32_t)((uint64_t)wordCount * 1000 / MAX(tapeTimeMS, 1U)));
+    }
+
+    return loadComplete;
+}
+
+size_t BuildFrame(LoadDataSource& dataSrc, uint8_t * frameBuf, size_t& dataLen)
+{
+    uint16_t data, addr, frameAddr = NO_ADDR;
+    uint8_t checksum = 0;
+
+    // Collect a run of words with consecutive addresses.
+    dataLen = 0;
+    while (dataLen < kMaxFrameDataLen && !dataSrc.AtEnd() && dataSrc.GetWord(data, addr)) {
+        if (dataLen == 0) {
+            frameAddr = addr;
+        }
+        else if (addr != frameAddr + dataLen) {
+            break;
+        }
+        frameBuf[kFrameHeaderLen + dataLen++] = (uint8_t)data;
+        frameBuf[kFrameHeaderLen + dataLen++] = (uint8_t)(data >> 8);
+        dataSrc.Advance();
+    }
+
+    if (dataLen == 0) {
+        return 0;
+    }
+
+    frameBuf[0] = (uint8_t)frameAddr;
+    frameBuf[1] = (uint8_t)(frameAddr >> 8);
+    frameBuf[2] = (uint8_t)dataLen;
+    frameBuf[3] = (uint8_t)(dataLen >> 8);
+    frameBuf[4] = (uint8_t)-(frameBuf[0] + frameBuf[1] + frameBuf[2] + frameBuf[3]);
+
+    // Compute a checksum such that the sum of the data bytes and the
+    // checksum is zero.
+    for (size_t i = 0; i < dataLen; i++) {
+        checksum = (uint8_t)(checksum + frameBuf[kFrameHeaderLen + i]);
+    }
+    frameBuf[kFrameHeaderLen + dataLen] = (uint8_t)-checksum;
+
+    return kFrameHeaderLen + dataLen + kFrameTrailerLen;
+}
+
+size_t BuildEndFrame(uint16_t startAddr, uint8_t * frameBuf)
+{
+    // An odd start address (including NO_ADDR) instructs the loader to halt.
+
+    frameBuf[0] = (uint8_t)startAddr;
+    frameBuf[1] = (uint8_t)(startAddr >> 8);
+    frameBuf[2] = 0;
+    frameBuf[3] = 0;
+    frameBuf[4] = (uint8_t)-(frameBuf[0] + frameBuf[1]);
+    frameBuf[5] = 0;
+
+    return kFrameHeaderLen + kFrameTrailerLen;
+}
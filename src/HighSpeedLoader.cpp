@@ -0,0 +1,153 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConsoleAdapter.h"
+#include "HighSpeedLoader.h"
+
+/** Resident high-speed loader code
+ *
+ * The code is position independent and is loaded at the end of memory. It
+ * reads bytes directly from the console receiver (which is fed by the console
+ * adapter at the full speed of the SCL) and does not use the stack, so that
+ * images may be loaded right up to the start of the loader.
+ *
+ * A frame's data is stored as it arrives, but only after the frame header has
+ * been checked, so that a corrupted header does not cause data to be stored
+ * at the wrong address, and never over the loader itself.  On
+ * rejecting a header, the loader discards input until the line has been idle
+ * for 65536 polls (roughly one second on an 11/05), so that the remainder of
+ * the frame is not mistaken for the next header, and then replies NAK.
+ *
+ * Registers: R0 = frame checksum, R1 = store pointer, R2 = byte count,
+ * R3 = current byte/reply, R4 = console receiver CSR, R5 = return address.
+ */
+static const uint16_t sHighSpeedLoaderCode[] = {
+    0012704, 0177560,   // 000  START:  MOV     #177560,R4      ; console receiver CSR
+    0012703, 0000006,   // 004          MOV     #6,R3           ; signal ready with ACK
+    0105764, 0000004,   // 010  RDY:    TSTB    4(R4)
+    0100375,            // 014          BPL     RDY
+    0110364, 0000006,   // 016          MOVB    R3,6(R4)
+    0005000,            // 022  FRAME:  CLR     R0
+    0010701,            // 024          MOV     PC,R1           ; read frame header
+    0062701, 0000232,   // 026          ADD     #HDR-.,R1
+    0012702, 0000005,   // 032          MOV     #5,R2
+    0010705,            // 036          MOV     PC,R5
+    0000475,            // 040          BR      READ
+    0105700,            // 042          TSTB    R0              ; check header checksum
+    0001062,            // 044          BNE     BAD
+    0016701, 0000206,   // 046          MOV     HDR,R1          ; check header count
+    0016702, 0000204,   // 052          MOV     CNT,R2
+    0001415,            // 056          BEQ     CKSUM
+    0020227, 0001000,   // 060          CMP     R2,#1000
+    0101052,            // 064          BHI     BAD
+    0010103,            // 066          MOV     R1,R3           ; check data ends at or
+    0060203,            // 070          ADD     R2,R3           ; below start of loader
+    0103447,            // 072          BCS     BAD
+    0010705,            // 074          MOV     PC,R5
+    0162705, 0000076,   // 076          SUB     #.-START,R5
+    0020305,            // 102          CMP     R3,R5
+    0101042,            // 104          BHI     BAD
+    0010705,            // 106          MOV     PC,R5           ; read frame data
+    0000451,            // 110          BR      READ
+    0010701,            // 112  CKSUM:  MOV     PC,R1           ; read frame checksum
+    0062701, 0000150,   // 114          ADD     #CKS-.,R1
+    0012702, 0000001,   // 120          MOV     #1,R2
+    0010705,            // 124          MOV     PC,R5
+    0000442,            // 126          BR      READ
+    0012703, 0000006,   // 130          MOV     #6,R3           ; reply ACK or NAK
+    0105700,            // 134          TSTB    R0
+    0001402,            // 136          BEQ     REPLY
+    0012703, 0000025,   // 140  NAK:    MOV     #25,R3
+    0105764, 0000004,   // 144  REPLY:  TSTB    4(R4)
+    0100375,            // 150          BPL     REPLY
+    0110364, 0000006,   // 152          MOVB    R3,6(R4)
+    0122703, 0000025,   // 156          CMPB    R3,#25          ; on error, await resend
+    0001717,            // 162          BEQ     FRAME
+    0016702, 0000072,   // 164          MOV     CNT,R2          ; on data frame, await next
+    0001314,            // 170          BNE     FRAME
+    0016701, 0000062,   // 172          MOV     HDR,R1          ; end frame: start program
+    0032701, 0000001,   // 176          BIT     #1,R1           ; or halt if address is odd
+    0001001,            // 202          BNE     DONE
+    0000111,            // 204          JMP     (R1)
+    0000000,            // 206  DONE:   HALT
+    0000776,            // 210          BR      DONE
+    0005002,            // 212  BAD:    CLR     R2              ; on bad header, discard
+    0105714,            // 214  DRAIN:  TSTB    (R4)            ; input until line is idle
+    0100003,            // 216          BPL     IDLE            ; and then reply NAK
+    0105764, 0000002,   // 220          TSTB    2(R4)
+    0000772,            // 224          BR      BAD
+    0005302,            // 226  IDLE:   DEC     R2
+    0001371,            // 230          BNE     DRAIN
+    0000742,            // 232          BR      NAK
+    0105714,            // 234  READ:   TSTB    (R4)            ; read R2 bytes to (R1)+
+    0100376,            // 236          BPL     READ
+    0116403, 0000002,   // 240          MOVB    2(R4),R3
+    0060300,            // 244          ADD     R3,R0
+    0110321,            // 246          MOVB    R3,(R1)+
+    0005302,            // 250          DEC     R2
+    0001370,            // 252          BNE     READ
+    0000165, 0000002,   // 254          JMP     2(R5)           ; return past caller's BR
+    0000000,            // 260  HDR:    frame address
+    0000000,            // 262  CNT:    frame byte count
+    0000000             // 264  CKS:    header and frame checksums
+};
+constexpr static size_t sHighSpeedLoaderCodeLen = sizeof(sHighSpeedLoaderCode) / sizeof(sHighSpeedLoaderCode[0]);
+
+bool HighSpeedLoaderDataSource::GetWord(uint16_t& data, uint16_t& addr)
+{
+    if (mCurWord < sHighSpeedLoaderCodeLen) {
+        addr = mLoadAddr + ((uint16_t)mCurWord * 2);
+        data = sHighSpeedLoaderCode[mCurWord];
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+void HighSpeedLoaderDataSource::Advance(void)
+{
+    if (mCurWord < sHighSpeedLoaderCodeLen) {
+        mCurWord++;
+    }
+}
+
+bool HighSpeedLoaderDataSource::AtEnd(void)
+{
+    return mCurWord >= sHighSpeedLoaderCodeLen;
+}
+
+uint16_t HighSpeedLoaderDataSource::GetStartAddress(void)
+{
+    return mLoadAddr;
+}
+
+void HighSpeedLoaderDataSource::Rewind(void)
+{
+    mCurWord = 0;
+}
+
+uint16_t HighSpeedLoaderDataSource::MemSizeToLoadAddr(uint32_t memSizeKW)
+{
+    if (memSizeKW < 4) {
+        memSizeKW = 4;
+    }
+    else if (memSizeKW > 28) {
+        memSizeKW = 28;
+    }
+    // High-speed loader placed at end of memory
+    return (uint16_t)(memSizeKW * 2048) - sizeof(sHighSpeedLoaderCode);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HIGH_SPEED_LOADER_H
+#define HIGH_SPEED_LOADER_H
+
+/** Data source for a small resident loader program that receives memory
+ *  images from the console adapter over the console serial line
+ *
+ * Once started, the loader sends an ACK character to signal that it is ready,
+ * and then reads a sequence of frames, each of which has the form:
+ *
+ *     addrLo addrHi countLo countHi hdrChecksum data[count] checksum
+ *
+ * where count is the number of data bytes in the frame (at most 512),
+ * hdrChecksum is such that the sum of the header bytes (modulo 256) is zero,
+ * and checksum is such that the sum of the data bytes and checksum (modulo
+ * 256) is zero.  The loader rejects any frame whose header checksum is
+ * invalid, whose count exceeds 512, or whose data would extend beyond the
+ * start of the loader.  Otherwise it stores the data bytes starting at the
+ * given address.  The loader replies to each frame with ACK if the frame is
+ * valid, or NAK otherwise. A frame with a count of zero ends the load: if its
+ * address is even the loader jumps to it, otherwise the loader halts.
+ */
+class HighSpeedLoaderDataSource final : public LoadDataSource
+{
+public:
+    HighSpeedLoaderDataSource(uint16_t loadAddr);
+    ~HighSpeedLoaderDataSource() = default;
+    HighSpeedLoaderDataSource(const HighSpeedLoaderDataSource&) = delete;
+
+    virtual bool GetWord(uint16_t& data, uint16_t& addr);
+    virtual void Advance(void);
+    virtual bool AtEnd(void);
+    virtual uint16_t GetStartAddress(void);
+    virtual void Rewind(void);
+
+    static uint16_t MemSizeToLoadAddr(uint32_t memSize);
+
+    static constexpr char kFrameAck = '\x06';
+    static constexpr char kFrameNak = '\x15';
+
+private:
+    const uint16_t mLoadAddr;
+    size_t mCurWord;
+};
+
+inline HighSpeedLoaderDataSource::HighSpeedLoaderDataSource(uint16_t loadAddr)
+: mLoadAddr(loadAddr), mCurWord(0)
+{
+}
+
+#endif // HIGH_SPEED_LOADER_H
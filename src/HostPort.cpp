@@ -22,14 +22,221 @@
 HostPort gHostPort;
 
 SerialConfig HostPort::sSerialConfig = { SCL_DEFAULT_BAUD_RATE, 8, 1, SerialConfig::PARITY_NONE };
+RingBuffer<HOST_TX_BUFFER_SIZE> HostPort::sTxBuf;
+uint HostPort::sTxIRQ;
+volatile bool HostPort::sTxFlushScheduled;
+volatile uint32_t HostPort::sUSBFlushCount;
+volatile uint32_t HostPort::sUSBByteCount;
+uint32_t HostPort::sDroppedCount;
 static bool sSerialConfigChanged;
 
+// Size of a USB full-speed bulk packet
+static constexpr size_t kUSBPacketSize = 64;
+
 void HostPort::Init(void)
 {
     // Initialize stdio
     // Disable automatic translation of CR/LF
     stdio_usb_init();
     stdio_set_translate_crlf(&stdio_usb, false);
+
+    // Claim a user IRQ for passing buffered output characters to TinyUSB.
+    //
+    // Calls into TinyUSB must not overlap those made by the stdio_usb
+    // background task, which runs from a higher priority IRQ while holding
+    // the stdio_usb mutex.  The transmit IRQ runs at the lowest priority,
+    // so that it can never preempt the background task part way through,
+    // and disables interrupts while it calls into TinyUSB so that the
+    // background task can't preempt it in turn.  Code running outside of
+    // an IRQ masks the transmit IRQ while it reads via the stdio_usb driver.
+    sTxIRQ = (uint)user_irq_claim_unused(true);
+    irq_set_exclusive_handler(sTxIRQ, HandleTxIRQ);
+    irq_set_priority(sTxIRQ, PICO_LOWEST_IRQ_PRIORITY);
+    irq_set_enabled(sTxIRQ, true);
+}
+
+size_t HostPort::ReadSome(char * buf, size_t maxLen)
+{
+    // Read as many characters as are available via the stdio_usb driver,
+    // which holds the stdio_usb mutex while reading from TinyUSB.  The
+    // transmit IRQ is masked so that it can't call into TinyUSB part way
+    // through the read.  Other interrupts are left enabled.
+    irq_set_enabled(sTxIRQ, false);
+    int len = stdio_usb.in_chars(buf, (int)maxLen);
+    irq_set_enabled(sTxIRQ, true);
+
+    if (len <= 0) {
+        return 0;
+    }
+
+    ActivityLED::SysActive();
+
+    return (size_t)len;
+}
+
+void HostPort::Write(char ch)
+{
+    if (WaitTxSpace()) {
+        sTxBuf.Put(ch);
+        ScheduleTxFlush();
+    }
+    ActivityLED::SysActive();
+}
+
+void HostPort::Write(const char * str)
+{
+    while (*str != 0 && WaitTxSpace()) {
+        sTxBuf.Put(*str++);
+        if (sTxBuf.Count() >= kUSBPacketSize) {
+            ScheduleTxFlush();
+        }
+    }
+    ScheduleTxFlush();
+    ActivityLED::SysActive();
+}
+
+void HostPort::Forward(char ch, OverflowPolicy_t policy)
+{
+    switch (policy) {
+    case OverflowPolicy_DropOldest: {
+        char discardCh;
+
+        // If the transmit buffer is full, discard the oldest character to make
+        // room for the new one.  Interrupts are disabled to prevent the transmit
+        // IRQ (the buffer's consumer) from running at the same time.
+        uint32_t intState = save_and_disable_interrupts();
+        if (sTxBuf.IsFull()) {
+            sTxBuf.Get(discardCh);
+            sDroppedCount++;
+        }
+        sTxBuf.Put(ch);
+        restore_interrupts(intState);
+        ScheduleTxFlush();
+        break;
+    }
+    case OverflowPolicy_DropNewest:
+        if (sTxBuf.Put(ch)) {
+            ScheduleTxFlush();
+        }
+        else {
+            sDroppedCount++;
+        }
+        break;
+    default:
+        Write(ch);
+        return;
+    }
+    ActivityLED::SysActive();
+}
+
+void HostPort::Flush(void)
+{
+    absolute_time_t timeout = make_timeout_time_us(HOST_TX_TIMEOUT_US);
+
+    // Force any buffered characters to be sent immediately and wait for
+    // the buffer to drain, or until the host stops accepting data.
+    irq_set_pending(sTxIRQ);
+    while (!sTxBuf.IsEmpty() && stdio_usb_connected() && !time_reached(timeout)) {
+        tight_loop_contents();
+    }
+}
+
+bool HostPort::WaitTxSpace(void)
+{
+    if (!sTxBuf.IsFull()) {
+        return true;
+    }
+
+    absolute_time_t timeout = make_timeout_time_us(HOST_TX_TIMEOUT_US);
+
+    // Wait for space in the transmit buffer.  If the host is not connected,
+    // or is not accepting data, give up and discard the character.
+    irq_set_pending(sTxIRQ);
+    while (sTxBuf.IsFull()) {
+        if (!stdio_usb_connected() || time_reached(timeout)) {
+            return false;
+        }
+        tight_loop_contents();
+    }
+
+    return true;
+}
+
+void HostPort::ScheduleTxFlush(void)
+{
+    // If enough characters have accumulated to fill a USB packet, pass them
+    // to TinyUSB immediately.
+    if (sTxBuf.Count() >= kUSBPacketSize) {
+        irq_set_pending(sTxIRQ);
+    }
+
+    // Otherwise, arrange to pass them to TinyUSB after a short delay, giving
+    // subsequent characters a chance to be coalesced into the same transfer.
+    else if (!sTxFlushScheduled) {
+        sTxFlushScheduled = true;
+        if (add_alarm_in_us(HOST_TX_FLUSH_DELAY_US, HandleTxFlushAlarm, NULL, true) < 0) {
+            sTxFlushScheduled = false;
+            irq_set_pending(sTxIRQ);
+        }
+    }
+}
+
+void HostPort::HandleTxIRQ(void)
+{
+    char chunk[kUSBPacketSize];
+    uint32_t count = 0;
+
+    // If the host is not connected, discard any buffered characters.
+    if (!stdio_usb_connected()) {
+        char ch;
+        while (sTxBuf.Get(ch))
+            ;
+        return;
+    }
+
+    // Pass as many buffered characters to TinyUSB as it has room for and
+    // start a USB transfer.  The space check, the writes and the flush are
+    // done as a single step, so that the stdio_usb background task can't
+    // run in between.  Limiting the writes to the available space ensures
+    // TinyUSB never has to wait for room.
+    uint32_t intState = save_and_disable_interrupts();
+    uint32_t avail = tud_cdc_write_available();
+    while (count < avail) {
+        uint32_t chunkLen = 0;
+        while (chunkLen < sizeof(chunk) && count + chunkLen < avail && sTxBuf.Get(chunk[chunkLen])) {
+            chunkLen++;
+        }
+        if (chunkLen == 0) {
+            break;
+        }
+        tud_cdc_write(chunk, chunkLen);
+        count += chunkLen;
+    }
+    if (count > 0) {
+        tud_cdc_write_flush();
+    }
+    restore_interrupts(intState);
+
+    if (count > 0) {
+        sUSBFlushCount = sUSBFlushCount + 1;
+        sUSBByteCount = sUSBByteCount + count;
+    }
+
+    // If TinyUSB could not accept all the buffered characters, try again
+    // once the current USB transfer has had time to complete.
+    if (!sTxBuf.IsEmpty() && !sTxFlushScheduled) {
+        sTxFlushScheduled = true;
+        if (add_alarm_in_us(HOST_TX_FLUSH_DELAY_US, HandleTxFlushAlarm, NULL, true) < 0) {
+            sTxFlushScheduled = false;
+        }
+    }
+}
+
+int64_t HostPort::HandleTxFlushAlarm(alarm_id_t /* id */, void * /* userData */)
+{
+    sTxFlushScheduled = false;
+    irq_set_pending(sTxIRQ);
+    return 0;
 }
 
 bool HostPort::ConfigChanged(void)
@@ -19,6 +19,14 @@
 
 struct SerialConfig;
 
+/** Port representing the USB CDC serial interface to the host
+ *
+ * Characters written to the host port are collected in a transmit buffer
+ * and passed to TinyUSB in batches, either when enough characters have
+ * accumulated to fill a USB packet, or after a short delay.  This avoids
+ * sending a separate USB packet for each character when the PDP-11 is
+ * producing a steady stream of output.
+ */
 class HostPort final : public Port
 {
 public:
@@ -34,53 +42,67 @@ public:
 
     virtual char Read(void);
     virtual bool TryRead(char &ch);
+    virtual size_t ReadSome(char * buf, size_t maxLen);
     virtual void Write(char ch);
     virtual void Write(const char * str);
     virtual void Flush(void);
     virtual bool CanWrite(void);
 
+    void Forward(char ch, OverflowPolicy_t policy);
+    uint32_t DroppedCount(void);
+
+    static uint32_t USBFlushCount(void);
+    static uint32_t USBByteCount(void);
+
 private:
     static SerialConfig sSerialConfig;
+    static RingBuffer<HOST_TX_BUFFER_SIZE> sTxBuf;
+    static uint sTxIRQ;
+    static volatile bool sTxFlushScheduled;
+    static volatile uint32_t sUSBFlushCount;
+    static volatile uint32_t sUSBByteCount;
+    static uint32_t sDroppedCount;
+
+    static bool WaitTxSpace(void);
+    static void ScheduleTxFlush(void);
+    static void HandleTxIRQ(void);
+    static int64_t HandleTxFlushAlarm(alarm_id_t id, void * userData);
 };
 
 extern HostPort gHostPort;
 
 inline char HostPort::Read(void)
 {
-    char ch = stdio_getchar();
-    ActivityLED::SysActive();
+    char ch;
+    while (!TryRead(ch)) {
+        tight_loop_contents();
+    }
     return ch;
 }
 
 inline bool HostPort::TryRead(char& ch)
 {
-    if (stdio_get_until(&ch, 1, 0) == 1) {
-        ActivityLED::SysActive();
-        return true;
-    }
-    return false;
+    return ReadSome(&ch, 1) == 1;
 }
 
-inline void HostPort::Write(char ch)
+inline bool HostPort::CanWrite(void)
 {
-    stdio_putchar_raw(ch);
-    ActivityLED::SysActive();
+    return !sTxBuf.IsFull();
 }
 
-inline void HostPort::Write(const char * str)
+inline uint32_t HostPort::DroppedCount(void)
 {
-    stdio_put_string(str, (int)strlen(str), false, false);
-    ActivityLED::SysActive();
+    return sDroppedCount;
 }
 
-inline void HostPort::Flush(void)
+inline uint32_t HostPort::USBFlushCount(void)
 {
-    stdio_flush();
+    return sUSBFlushCount;
 }
 
-inline bool HostPort::CanWrite(void)
+inline uint32_t HostPort::USBByteCount(void)
 {
-    return true;
+    return sUSBByteCount;
 }
 
 #endif // HOST_PORT_H
\ No newline at end of file
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConsoleAdapter.h"
+#include "InputPacer.h"
+#include "Settings.h"
+
+RingBuffer<INPUT_PACER_BUFFER_SIZE> InputPacer::sBuf;
+bool InputPacer::sAwaitingEcho;
+bool InputPacer::sEchoReceived;
+bool InputPacer::sLineEndPending;
+uint64_t InputPacer::sLastSendTime;
+uint64_t InputPacer::sLastReceiveTime;
+uint32_t InputPacer::sLineTurnaroundUS;
+uint32_t InputPacer::sEchoTimeoutCount;
+volatile bool InputPacer::sAlarmActive;
+volatile bool InputPacer::sPaused;
+uint64_t InputPacer::sNextSendTime;
+
+bool InputPacer::IsEnabled(void)
+{
+    return Settings::InputPacing != Settings::InputPacing_Off;
+}
+
+void InputPacer::Service(void)
+{
+    char ch;
+
+    switch (Settings::InputPacing) {
+    case Settings::InputPacing_Echo:
+        ServiceEchoPacing();
+        break;
+    case Settings::InputPacing_Fixed:
+        ServiceFixedPacing();
+        break;
+    default:
+
+        // If pacing has been disabled, forward any remaining queued characters
+        // as fast as the SCL port will accept them.  (Note that the pacing alarm
+        // stops itself once it observes that pacing is no longer in fixed mode).
+        if (!sAlarmActive) {
+            while (gSCLPort.CanWrite() && sBuf.Get(ch)) {
+                gSCLPort.Write(ch);
+            }
+        }
+        sAwaitingEcho = sLineEndPending = false;
+        break;
+    }
+}
+
+void InputPacer::ServiceEchoPacing(void)
+{
+    char ch;
+    uint64_t now = time_us_64();
+
+    // Wait for the pacing alarm to stop if switching from fixed mode.
+    if (sAlarmActive) {
+        return;
+    }
+
+    // If waiting for the PDP-11 to echo the last character sent, continue
+    // waiting until it does so, or until the echo timeout expires.
+    if (sAwaitingEcho) {
+        if (!sEchoReceived) {
+            if ((now - sLastSendTime) < (uint64_t)Settings::EchoTimeoutMS * 1000) {
+                return;
+            }
+            sEchoTimeoutCount++;
+        }
+        sAwaitingEcho = false;
+    }
+
+    // If the last character sent was a carriage return, wait for the PDP-11 to
+    // finish responding to the line.  The response is considered complete once
+    // the PDP-11's output has gone idle and at least the learned line turnaround
+    // time has elapsed.
+    if (sLineEndPending) {
+        if ((now - sLastSendTime) < sLineTurnaroundUS ||
+            (now - sLastReceiveTime) < IdleTimeUS()) {
+            return;
+        }
+
+        // Update the learned line turnaround time based on the time at which the
+        // last character of the response was received.  A moving average is
+        // used, so that a single slow line (e.g. a command that lists a
+        // directory) doesn't throttle the remainder of the input.
+        uint32_t observedUS = (sLastReceiveTime > sLastSendTime)
+            ? (uint32_t)(sLastReceiveTime - sLastSendTime)
+            : 0;
+        int64_t deltaUS = (int64_t)observedUS - (int64_t)sLineTurnaroundUS;
+        sLineTurnaroundUS = (uint32_t)((int64_t)sLineTurnaroundUS + deltaUS / kTurnaroundAvgWeight);
+
+        sLineEndPending = false;
+    }
+
+    // Release the next queued character to the SCL port.
+    if (gSCLPort.CanWrite() && sBuf.Get(ch)) {
+        gSCLPort.Write(ch);
+        sLastSendTime = time_us_64();
+        sAwaitingEcho = true;
+        sEchoReceived = false;
+        sLineEndPending = (ch == '\r');
+    }
+}
+
+void InputPacer::ServiceFixedPacing(void)
+{
+    // If there are characters waiting to be sent and the pacing alarm is not
+    // running, start the alarm, arranging for it to fire when the next character
+    // is due to be sent.
+    if (!sAlarmActive && !sBuf.IsEmpty()) {
+        uint64_t now = time_us_64();
+        uint64_t delayUS = (sNextSendTime > now) ? sNextSendTime - now : 0;
+        sAwaitingEcho = sLineEndPending = false;
+        sAlarmActive = true;
+        if (add_alarm_in_us(delayUS, HandlePacingAlarm, NULL, true) < 0) {
+            sAlarmActive = false;
+        }
+    }
+}
+
+int64_t InputPacer::HandlePacingAlarm(alarm_id_t /* id */, void * /* userData */)
+{
+    char ch;
+    uint32_t count = 0;
+    int64_t delayUS = (int64_t)Settings::PaceCharDelayMS * 1000;
+
+    // Stop if fixed pacing has been disabled or paused, or there is nothing
+    // more to send.
+    if (Settings::InputPacing != Settings::InputPacing_Fixed || sPaused || sBuf.IsEmpty()) {
+        sAlarmActive = false;
+        return 0;
+    }
+
+    // Send a burst of characters to the SCL port, ending the burst early if
+    // a carriage return is sent.
+    while (count < Settings::PaceBurstSize && gSCLPort.CanWrite() && sBuf.Get(ch)) {
+        gSCLPort.Write(ch);
+        count++;
+        if (ch == '\r') {
+            delayUS = (int64_t)Settings::PaceLineDelayMS * 1000;
+            break;
+        }
+    }
+
+    // If the SCL port could not accept any characters, try again shortly.
+    if (count == 0) {
+        delayUS = 1000;
+    }
+
+    // Reschedule the alarm to fire when the next burst is due.  (A negative
+    // return value tells the SDK to reschedule relative to the current time).
+    delayUS = MAX(delayUS, (int64_t)100);
+    sNextSendTime = time_us_64() + (uint64_t)delayUS;
+    return -delayUS;
+}
+
+void InputPacer::NotifyReceived(void)
+{
+    // Note the arrival of output from the PDP-11.  Any character received
+    // after a character is sent is taken to be its echo, since PDP-11 software
+    // does not always echo characters verbatim (e.g. CR is often echoed as
+    // CR LF).
+    sLastReceiveTime = time_us_64();
+    if (sAwaitingEcho) {
+        sEchoReceived = true;
+    }
+}
+
+size_t InputPacer::Discard(void)
+{
+    char ch;
+    size_t count = 0;
+    while (sBuf.Get(ch)) {
+        count++;
+    }
+    return count;
+}
+
+void InputPacer::Pause(void)
+{
+    // Stop the pacing alarm from sending any more characters.  The alarm
+    // fires on this core, so it cannot be part way through sending a burst
+    // when this is called.
+    sPaused = true;
+}
+
+void InputPacer::Resume(void)
+{
+    // Allow pacing to continue.  If necessary, the next call to Service()
+    // restarts the pacing alarm.
+    sPaused = false;
+}
+
+uint32_t InputPacer::IdleTimeUS(void)
+{
+    // The PDP-11's output is considered idle once nothing has been received
+    // for the time it takes to transmit 4 characters.
+    return (4 * 10 * 1000000) / gSCLPort.GetConfig().BitRate;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INPUT_PACER_H
+#define INPUT_PACER_H
+
+/** Paces characters sent from the host to the PDP-11
+ *
+ * When input pacing is enabled, characters received from the user in
+ * terminal mode are queued in a RAM buffer and released to the SCL port
+ * at a rate that the PDP-11 software can accept.
+ *
+ * In echo mode, the next character is released only after the PDP-11 has
+ * echoed the previous one, or after a timeout.  Following a carriage return,
+ * the pacer also waits for the PDP-11 to finish responding to the line.
+ * The time this takes is learned from the lines already sent, so that a
+ * pause in the PDP-11's output is not mistaken for the end of its response.
+ *
+ * In fixed mode, for use with PDP-11 software that does not echo its input,
+ * characters are released in bursts of a configurable size, separated by a
+ * fixed inter-character delay, with a longer delay following each carriage
+ * return.  Fixed mode is driven by a hardware alarm, so that pacing remains
+ * accurate regardless of what the main loop is doing.
+ *
+ * Pacing is paused whenever terminal mode is left (e.g. for the menu), so
+ * that queued characters are not mixed in with commands that the adapter
+ * sends to the PDP-11's console.
+ */
+class InputPacer final
+{
+public:
+    static bool IsEnabled(void);
+    static bool Enqueue(char ch);
+    static size_t Space(void);
+    static size_t Pending(void);
+    static void Service(void);
+    static void NotifyReceived(void);
+    static size_t Discard(void);
+    static void Pause(void);
+    static void Resume(void);
+    static uint32_t EchoTimeoutCount(void);
+    static uint32_t LineTurnaroundUS(void);
+
+private:
+    static RingBuffer<INPUT_PACER_BUFFER_SIZE> sBuf;
+    static bool sAwaitingEcho;
+    static bool sEchoReceived;
+    static bool sLineEndPending;
+    static uint64_t sLastSendTime;
+    static uint64_t sLastReceiveTime;
+    static uint32_t sLineTurnaroundUS;
+    static uint32_t sEchoTimeoutCount;
+    static volatile bool sAlarmActive;
+    static volatile bool sPaused;
+    static uint64_t sNextSendTime;
+
+    // The learned line turnaround time moves 1/kTurnaroundAvgWeight of the
+    // way toward the time observed for each new line.
+    static constexpr int64_t kTurnaroundAvgWeight = 4;
+
+    static void ServiceEchoPacing(void);
+    static void ServiceFixedPacing(void);
+    static int64_t HandlePacingAlarm(alarm_id_t id, void * userData);
+    static uint32_t IdleTimeUS(void);
+};
+
+inline bool InputPacer::Enqueue(char ch)
+{
+    return sBuf.Put(ch);
+}
+
+inline size_t InputPacer::Space(void)
+{
+    return sBuf.Space();
+}
+
+inline size_t InputPacer::Pending(void)
+{
+    return sBuf.Count();
+}
+
+inline uint32_t InputPacer::EchoTimeoutCount(void)
+{
+    return sEchoTimeoutCount;
+}
+
+inline uint32_t InputPacer::LineTurnaroundUS(void)
+{
+    return sLineTurnaroundUS;
+}
+
+#endif // INPUT_PACER_H
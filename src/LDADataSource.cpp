@@ -22,9 +22,11 @@
 #include "LDADataSource.h"
 
 LDADataSource::LDADataSource(const uint8_t * buf, size_t len)
-: mReader(buf, len), mOverrideLoadAddr(NO_ADDR)
+: mReader(buf, len), mOverrideLoadAddr(NO_ADDR), mOverrideBaseAddr(NO_ADDR),
+  mStartAddr(NO_ADDR), mOrderByAddr(false), mBlockCount(0), mBlockIndex(0)
 {
-    mReader.NextBlock();
+    PlanBlockOrder();
+    Rewind();
 }
 
 bool LDADataSource::GetWord(uint16_t& data, uint16_t& addr)
@@ -46,32 +48,51 @@ bool LDADataSource::GetWord(uint16_t& data, uint16_t& addr)
 
 void LDADataSource::Advance(void)
 {
+    AdvanceRun(2);
+}
+
+bool LDADataSource::GetRun(uint16_t& addr, const uint8_t *& data, size_t& len)
+{
+    // Skip any data blocks that contain no data.
+    while (!AtEnd() && mReader.mDataLen == 0) {
+        NextBlock();
+    }
+
+    // The run consists of the remaining data in the current block.
     if (!AtEnd()) {
+        addr = (mOverrideLoadAddr != NO_ADDR) ? mOverrideLoadAddr : mReader.mLoadAddr;
+        data = mReader.mDataPtr;
+        len = mReader.mDataLen;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
 
-        // Advance to the next data word, or to the end of the current data block
-        if (mReader.mDataLen <= 2) {
-            mReader.mDataPtr += mReader.mDataLen;
-            mReader.mDataLen = 0;
-        }
-        else {
-            mReader.mDataPtr += 2;
-            mReader.mDataLen -= 2;
-        }
+void LDADataSource::AdvanceRun(size_t len)
+{
+    if (!AtEnd()) {
 
-        // If we've consumed all the data in the current block, advance to the
-        // next block.  This will also setup a new load address.
-        if (mReader.mDataLen == 0) {
-            mReader.NextBlock();
+        // Advance by whole words.  If this consumes all the data in the
+        // current block, advance to the next block.  This will also setup a
+        // new load address.
+        len = (len + 1) & ~(size_t)1;
+        if (len >= mReader.mDataLen) {
+            len = (mReader.mDataLen + 1) & ~(size_t)1;
+            NextBlock();
         }
 
-        // Otherwise, advance the load address.
+        // Otherwise, advance within the current block.
         else {
-            mReader.mLoadAddr += 2;
+            mReader.mDataPtr += len;
+            mReader.mDataLen -= len;
+            mReader.mLoadAddr = (uint16_t)(mReader.mLoadAddr + len);
         }
 
         // Advance the override load address, if active.
         if (mOverrideLoadAddr != NO_ADDR) {
-            mOverrideLoadAddr += 2;
+            mOverrideLoadAddr = (uint16_t)(mOverrideLoadAddr + len);
         }
     }
 }
@@ -83,11 +104,114 @@ bool LDADataSource::AtEnd(void)
 
 uint16_t LDADataSource::GetStartAddress(void)
 {
-    return mReader.mStartAddr;
+    return (mReader.mStartAddr != NO_ADDR) ? mReader.mStartAddr : mStartAddr;
+}
+
+void LDADataSource::Rewind(void)
+{
+    mReader.Rewind();
+    mOverrideLoadAddr = mOverrideBaseAddr;
+    if (mOrderByAddr) {
+        SeekOrderedBlock(0);
+    }
+    else {
+        mReader.NextBlock();
+    }
+}
+
+void LDADataSource::SetOverrideLoadAddress(uint16_t loadAddr)
+{
+    // When loading at an overridden address, blocks are placed one after
+    // another in the order they appear in the file.
+    mOverrideBaseAddr = loadAddr;
+    mOrderByAddr = false;
+    Rewind();
+}
+
+void LDADataSource::NextBlock(void)
+{
+    if (mOrderByAddr) {
+        SeekOrderedBlock(mBlockIndex + 1);
+    }
+    else {
+        mReader.NextBlock();
+    }
+}
+
+void LDADataSource::SeekOrderedBlock(size_t index)
+{
+    mBlockIndex = index;
+    mReader.SeekBlock((index < mBlockCount) ? mBlockOrder[index] : mReader.mInputBuf + mReader.mInputLen);
+}
+
+void LDADataSource::PlanBlockOrder(void)
+{
+    LDAReader reader(mReader.mInputBuf, mReader.mInputLen);
+    uint16_t blockAddrs[LDA_MAX_ORDERED_BLOCKS];
+    uint32_t prevEndAddr = 0;
+    bool reordered = false;
+
+    // Scan the entire file to locate the start address, recording the
+    // position and load address of each data block.  If the file is
+    // damaged, load it in file order, stopping at the point of the error.
+    // Likewise, if the file contains too many blocks to be ordered, load
+    // it in file order.
+    mBlockCount = 0;
+    while (reader.NextBlock()) {
+        if (mBlockCount < LDA_MAX_ORDERED_BLOCKS) {
+            blockAddrs[mBlockCount] = reader.mLoadAddr;
+            mBlockOrder[mBlockCount] = reader.mReadPtr;
+        }
+        mBlockCount++;
+    }
+    if (reader.mReadError) {
+        return;
+    }
+    mStartAddr = reader.mStartAddr;
+    if (mBlockCount > LDA_MAX_ORDERED_BLOCKS) {
+        return;
+    }
+
+    // Sort the data blocks in order of increasing load address.  Loading the
+    // blocks in this order allows the console's auto-increment feature to
+    // carry over from one block to the next whenever blocks are contiguous
+    // in memory, eliminating the set address (L) command that would
+    // otherwise be needed at the start of each block.
+    //
+    // An insertion sort is used, which preserves the file order of blocks
+    // with the same load address.
+    for (size_t i = 1; i < mBlockCount; i++) {
+        uint16_t addr = blockAddrs[i];
+        const uint8_t * block = mBlockOrder[i];
+        size_t j = i;
+        for (; j > 0 && blockAddrs[j - 1] > addr; j--) {
+            blockAddrs[j] = blockAddrs[j - 1];
+            mBlockOrder[j] = mBlockOrder[j - 1];
+        }
+        if (j != i) {
+            blockAddrs[j] = addr;
+            mBlockOrder[j] = block;
+            reordered = true;
+        }
+    }
+
+    // Because later blocks in an LDA file can overwrite earlier ones, blocks
+    // can only be safely reordered if none of them overlap.  If an overlap is
+    // found, fall back to loading the blocks in file order.
+    for (size_t i = 0; i < mBlockCount; i++) {
+        reader.SeekBlock(mBlockOrder[i]);
+        if (reader.mLoadAddr < prevEndAddr) {
+            return;
+        }
+        prevEndAddr = (uint32_t)reader.mLoadAddr + ((reader.mDataLen + 1) & ~(size_t)1);
+    }
+
+    // Only load by address if doing so differs from file order.
+    mOrderByAddr = reordered;
 }
 
 LDAReader::LDAReader(const uint8_t* buf, size_t len)
-: mInputBuf(buf), mReadPtr(buf), mRemainingLen(len), 
+: mInputBuf(buf), mInputLen(len), mReadPtr(buf), mRemainingLen(len), 
   mDataPtr(NULL), mBlockLen(0), mDataLen(0),
   mLoadAddr(NO_ADDR), mStartAddr(NO_ADDR), mReadError(false)
 {
@@ -188,6 +312,26 @@ bool LDAReader::NextBlock(void)
     return true;
 }
 
+bool LDAReader::SeekBlock(const uint8_t * blockPtr)
+{
+    mReadPtr = blockPtr;
+    mRemainingLen = (size_t)((mInputBuf + mInputLen) - blockPtr);
+    mBlockLen = 0;
+    return NextBlock();
+}
+
+void LDAReader::Rewind(void)
+{
+    mReadPtr = mInputBuf;
+    mRemainingLen = mInputLen;
+    mDataPtr = NULL;
+    mBlockLen = 0;
+    mDataLen = 0;
+    mLoadAddr = NO_ADDR;
+    mStartAddr = NO_ADDR;
+    mReadError = false;
+}
+
 bool LDAReader::AtEnd(void) const
 {
     return mRemainingLen == 0;
@@ -23,6 +23,7 @@ public:
     LDAReader(const uint8_t * buf, size_t len);
 
     const uint8_t * const mInputBuf;
+    const size_t mInputLen;
     const uint8_t * mReadPtr;
     size_t mRemainingLen;
     const uint8_t *mDataPtr;
@@ -33,6 +34,8 @@ public:
     bool mReadError;
 
     bool NextBlock(void);
+    bool SeekBlock(const uint8_t * blockPtr);
+    void Rewind(void);
     bool AtEnd(void) const;
 
     static bool IsValidLDAFile(const uint8_t* fileData, size_t fileLen);
@@ -49,12 +52,25 @@ public:
     virtual void Advance(void);
     virtual bool AtEnd(void);
     virtual uint16_t GetStartAddress(void);
+    virtual void Rewind(void);
+    virtual bool GetRun(uint16_t& addr, const uint8_t *& data, size_t& len);
+    virtual void AdvanceRun(size_t len);
 
     void SetOverrideLoadAddress(uint16_t loadAddr);
 
 private:
     LDAReader mReader;
     uint16_t mOverrideLoadAddr;
+    uint16_t mOverrideBaseAddr;
+    uint16_t mStartAddr;
+    bool mOrderByAddr;
+    size_t mBlockCount;
+    size_t mBlockIndex;
+    const uint8_t * mBlockOrder[LDA_MAX_ORDERED_BLOCKS];
+
+    void PlanBlockOrder(void);
+    void NextBlock(void);
+    void SeekOrderedBlock(size_t index);
 };
 
 #endif // LDA_DATA_SOURCE_H
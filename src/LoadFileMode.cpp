@@ -14,15 +14,177 @@
  * limitations under the License.
  */
 
+#include <inttypes.h>
+
 #include "ConsoleAdapter.h"
 #include "M93xxController.h"
+#include "MemoryClear.h"
+#include "MemoryImage.h"
+#include "LoadVerifier.h"
+#include "Settings.h"
+#include "Core1.h"
+
+static bool LoadImage(Port& uiPort, LoadDataSource& dataSrc, const char * fileName, bool resume);
+static bool PlanMemoryClear(Port& uiPort, LoadDataSource& dataSrc, MemoryClearDataSource& clearSrc,
+                            ZeroSkipDataSource& skipSrc);
+static uint32_t SkipWords(LoadDataSource& dataSrc, uint32_t wordCount);
+static uint32_t SpotCheckTimeMS(const MemoryClearDataSource& clearSrc);
+
+// Sparse memory image used to stage files for loading
+static MemoryImage sImage;
+
+// Progress of the last load from the memory image that did not complete,
+// from which the load can be resumed.
+static struct
+{
+    bool Valid;
+    bool ClearDone;
+    uint32_t WordsLoaded;
+    char FileName[MAX_FILE_NAME_LEN + 64];
+} sCheckpoint;
+
+bool LoadFileMode(Port& uiPort, LoadDataSource& fileSrc, const char * fileName)
+{
+    // Loading a new file replaces the contents of the memory image, so the
+    // previous load can no longer be resumed.
+    sCheckpoint.Valid = false;
+    strncpy(sCheckpoint.FileName, fileName, sizeof(sCheckpoint.FileName) - 1);
+
+    // Materialize the file's contents into a sparse memory image and load
+    // from that, so that words are deposited in address order and words
+    // loaded more than once (e.g. by overlapping LDA blocks) are deposited
+    // only once.  If the file is too large for the image, load directly from
+    // the file.
+    LoadDataSource& dataSrc = sImage.Materialize(fileSrc) ? static_cast<LoadDataSource&>(sImage) : fileSrc;
+
+    return LoadImage(uiPort, dataSrc, fileName, false);
+}
+
+void BeginBatchLoad(void)
+{
+    // Staging files for a batch load replaces the contents of the memory
+    // image, so the previous load can no longer be resumed.
+    sCheckpoint.Valid = false;
+    sImage.Clear();
+}
+
+bool AddToBatchLoad(LoadDataSource& fileSrc)
+{
+    return sImage.Add(fileSrc);
+}
 
-void LoadFileMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName)
+bool BatchLoadMode(Port& uiPort, const char * batchName, uint16_t startAddr)
+{
+    // Load all the staged files in a single console session, finishing with
+    // the given start address.
+    strncpy(sCheckpoint.FileName, batchName, sizeof(sCheckpoint.FileName) - 1);
+    sImage.SetStartAddress(startAddr);
+    sImage.Rewind();
+
+    return LoadImage(uiPort, sImage, batchName, false);
+}
+
+uint32_t BatchLoadWordCount(void)
+{
+    return sImage.WordCount();
+}
+
+uint16_t BatchLoadStartAddress(void)
+{
+    return sImage.GetStartAddress();
+}
+
+bool CanResumeLoad(void)
+{
+    return sCheckpoint.Valid;
+}
+
+bool ResumeLoadFileMode(Port& uiPort)
+{
+    if (!sCheckpoint.Valid) {
+        return false;
+    }
+    return LoadImage(uiPort, sImage, sCheckpoint.FileName, true);
+}
+
+bool LoadImage(Port& uiPort, LoadDataSource& dataSrc, const char * fileName, bool resume)
 {
     M93xxController m93xxCtr;
+    LoadVerifier verifier(m93xxCtr, dataSrc, Settings::VerifyLoad == Settings::VerifyLoad_Repair);
+    MemoryClearDataSource clearSrc;
+    ZeroSkipDataSource skipSrc(dataSrc, clearSrc);
+    LoadDataSource * curSrc = &dataSrc;
+    LoadDataSource * imageSrc = &dataSrc;
     bool startAddrLoaded = false;
+    bool clearStartAddrLoaded = false;
+    bool clearStarted = false;
+    bool verifyStarted = false;
+    bool loadComplete = false;
+    uint32_t wordsIssued = 0, wordsSkipped = 0;
+    uint32_t cmdCount, charCount;
+    uint16_t runAddr = 0;
+    const uint8_t * runData = NULL;
+    size_t runLen = 0, runPos = 0;
+
+    // Take over reading the console's output from core1 for the duration
+    // of the load.
+    Core1::SuspendForwarding();
+
+    // Scale the console timeouts to the current SCL baud rate.
+    m93xxCtr.SetCharTime(gSCLPort.GetConfig().CharTimeUS());
+
+    // Overlap sending commands with the console's responses to previous
+    // commands.
+    m93xxCtr.SetPipelineWindow(M93XX_PIPELINE_WINDOW);
+
+    // If resuming an interrupted load, carry on from the last word the
+    // console is known to have deposited.  If the memory clear routine had
+    // already been run, skip the cleared words as before.  The console is
+    // contacted afresh, and a set address command issued, before the first
+    // deposit.
+    if (resume && (sCheckpoint.ClearDone || sCheckpoint.WordsLoaded > 0)) {
+        uiPort.Printf(TITLE_PREFIX "RESUMING LOAD: %s\r\n", fileName);
+        if (sCheckpoint.ClearDone) {
+            clearSrc.Plan(dataSrc);
+            verifier.SpotCheckCleared(clearSrc);
+            imageSrc = curSrc = &skipSrc;
+        }
+        wordsIssued = wordsSkipped = SkipWords(*imageSrc, sCheckpoint.WordsLoaded);
+        uiPort.Printf(TITLE_PREFIX "SKIPPING %" PRIu32 " WORDS ALREADY LOADED\r\n", wordsSkipped);
+    }
+
+    else {
+        uiPort.Printf(TITLE_PREFIX "LOADING FILE: %s\r\n", fileName);
+
+        // Tell the user how much data will be sent to the console, and roughly
+        // how long that will take at the current SCL baud rate.
+        uint32_t estTimeMS = EstimateLoadTimeMS(dataSrc, cmdCount, charCount);
+        uiPort.Printf(TITLE_PREFIX "ESTIMATED TRANSFER: %" PRIu32 " commands, %" PRIu32 " characters (about %" PRIu32 " seconds)\r\n",
+                      cmdCount, charCount, (estTimeMS + 999) / 1000);
+
+        // If enabled, and the image contains long runs of zero words, and it
+        // would be quicker to do so, clear those runs using a memory clear
+        // routine and then load only the remaining words.  Because the routine
+        // re-enters the console emulator at an address that is specific to
+        // the console ROM in use (the console entry address setting), this is
+        // off unless the user opts in.
+        if (Settings::ClearZeroRuns && PlanMemoryClear(uiPort, dataSrc, clearSrc, skipSrc)) {
+            verifier.SpotCheckCleared(clearSrc);
+            curSrc = &clearSrc;
+            imageSrc = &skipSrc;
+        }
+
+        // If verifying, tell the user roughly how long that will take.
+        if (Settings::VerifyLoad != Settings::VerifyLoad_Off) {
+            uint32_t verifyTimeMS = (curSrc == &clearSrc)
+                ? EstimateVerifyTimeMS(skipSrc) + SpotCheckTimeMS(clearSrc)
+                : EstimateVerifyTimeMS(dataSrc);
+            uiPort.Printf(TITLE_PREFIX "ESTIMATED VERIFY: about %" PRIu32 " seconds\r\n",
+                          (verifyTimeMS + 999) / 1000);
+        }
+    }
 
-    uiPort.Printf(TITLE_PREFIX "LOADING FILE: %s\r\n", fileName);
+    uint64_t startTime = time_us_64();
 
     while (true) {
         char ch;
@@ -64,7 +226,11 @@ void LoadFileMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName)
             //   b) the load command is complete.
             // This is done *before* the character is echoed so that the message
             // appears ahead of the M9301/M9312 prompt.
-            if (m93xxCtr.IsReadyForCommand() && dataSrc.AtEnd()) {
+            // When verifying, the messages are issued once verification is
+            // complete.
+            if (m93xxCtr.IsReadyForCommand() && curSrc == imageSrc && imageSrc->AtEnd() &&
+                (verifyStarted || Settings::VerifyLoad == Settings::VerifyLoad_Off) &&
+                verifier.IsDone()) {
                 if (dataSrc.GetStartAddress() != NO_ADDR && !startAddrLoaded) {
                     uiPort.Write(TITLE_PREFIX "LOADING START ADDRESS\r\n");
                 }
@@ -78,14 +244,72 @@ void LoadFileMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName)
             WriteHostAuxPorts(ch);
         }
 
-        // If the M9301/M9312 is still processing the current command, wait until
-        // it's done.
-        if (!m93xxCtr.IsReadyForCommand()) {
+        // While verifying, collect the console's responses to examine commands
+        // and queue further examines as room in the pipeline allows.
+        if (verifyStarted && !verifier.IsDone()) {
+            verifier.Step(uiPort);
+            if (verifier.IsDone() && verifier.Succeeded()) {
+                if (dataSrc.GetStartAddress() != NO_ADDR) {
+                    uiPort.Write(TITLE_PREFIX "LOADING START ADDRESS\r\n");
+                }
+                else {
+                    uiPort.Write(TITLE_PREFIX "LOAD COMPLETE\r\n");
+                }
+            }
+            continue;
+        }
+
+        // If the M9301/M9312 can't accept another command yet, wait until it
+        // can.  When pipelining, this allows a new command to be queued while
+        // earlier commands are still being processed.
+        if (!m93xxCtr.CanQueueCommand()) {
             continue;
         }
 
         // If the last data word has been deposited...
-        if (dataSrc.AtEnd()) {
+        if (runPos >= runLen && curSrc->AtEnd()) {
+
+            // Wait for the console to finish processing all outstanding
+            // commands.
+            if (!m93xxCtr.IsReadyForCommand()) {
+                continue;
+            }
+
+            // If the memory clear routine has been deposited, set the address
+            // of the routine and start it.  Once the routine has finished and
+            // the console has issued a new prompt, load the remainder of the
+            // image.
+            if (curSrc == &clearSrc) {
+                if (!clearStartAddrLoaded) {
+                    m93xxCtr.SetAddress(clearSrc.GetStartAddress());
+                    clearStartAddrLoaded = true;
+                }
+                else if (!clearStarted) {
+                    uiPort.Write(TITLE_PREFIX "STARTING MEMORY CLEAR ROUTINE\r\n");
+                    m93xxCtr.Start();
+                    clearStarted = true;
+                }
+                else {
+                    curSrc = imageSrc;
+                }
+                continue;
+            }
+
+            // Verify the loaded words by examining memory, if enabled.  If any
+            // words don't match (and could not be repaired), stop without
+            // loading the start address.
+            if (!verifyStarted) {
+                verifyStarted = true;
+                if (Settings::VerifyLoad != Settings::VerifyLoad_Off) {
+                    uiPort.Write(TITLE_PREFIX "VERIFYING\r\n");
+                    verifier.Begin();
+                    continue;
+                }
+            }
+            if (!verifier.Succeeded()) {
+                uiPort.Write(TITLE_PREFIX "ERROR (memory does not match file)\r\n");
+                break;
+            }
 
             // If the data source specifies a start address, issue a final set
             // address command (L) with the start address
@@ -96,15 +320,28 @@ void LoadFileMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName)
             }
 
             // Otherwise the loading process is complete, so return to terminal mode
+            loadComplete = true;
             break;
         }
 
-        // Get the next word to be loaded from the data source, along with its
-        // load address; if the next word is not ready yet, wait until it is.
-        if (!dataSrc.GetWord(data, addr)) {
-            continue;
+        // If the current run of words has been loaded, get the next run from
+        // the data source; if the next run is not ready yet, wait until it is.
+        // Working through whole runs avoids calling into the data source for
+        // every word.
+        if (runPos >= runLen) {
+            if (!curSrc->GetRun(runAddr, runData, runLen)) {
+                continue;
+            }
+            runPos = 0;
         }
 
+        // Get the next word to be loaded, along with its load address.
+        data = runData[runPos];
+        if (runPos + 1 < runLen) {
+            data |= (uint16_t)(runData[runPos + 1] << 8);
+        }
+        addr = (uint16_t)(runAddr + runPos);
+
         // If the next deposit address is not equal to the load address for
         // the next word, issue a set address (L) command and wait for it
         // to complete.
@@ -116,8 +353,171 @@ void LoadFileMode(Port& uiPort, LoadDataSource& dataSrc, const char * fileName)
         // Issue a deposit command (D) to load the word into memory at the
         // target address
         m93xxCtr.Deposit(data);
+        if (curSrc == imageSrc) {
+            wordsIssued++;
+        }
+
+        // Advance to the next word; once the whole run has been loaded,
+        // advance the data source past it.
+        runPos += 2;
+        if (runPos >= runLen) {
+            curSrc->AdvanceRun(runLen);
+        }
+    }
+
+    // Summarize the load, including the rate at which words were deposited.
+    if (loadComplete) {
+        uint32_t elapsedMS = (uint32_t)((time_us_64() - startTime) / 1000);
+        uint32_t wordCount = wordsIssued - wordsSkipped;
+        uiPort.Printf(TITLE_PREFIX "LOADED %" PRIu32 " WORDS IN %" PRIu32 ".%01" PRIu32 " SECONDS (%" PRIu32 " words/sec)\r\n",
+                      wordCount, elapsedMS / 1000, (elapsedMS % 1000) / 100,
+                      (elapsedMS > 0) ? (uint32_t)(((uint64_t)wordCount * 1000) / elapsedMS) : 0);
+    }
+
+    // Report any errors in the console's output that were recovered from.
+    if (m93xxCtr.ErrorCount() > 0) {
+        uiPort.Printf(TITLE_PREFIX "CONSOLE ERRORS: %" PRIu32 " (recovered by resynchronizing %" PRIu32 " times)\r\n",
+                      m93xxCtr.ErrorCount(), m93xxCtr.RecoveryCount());
+    }
+
+    // If loading from the memory image, record how far the load got so that
+    // it can be resumed if it didn't complete.  Words whose deposit commands
+    // have not been confirmed by the console are treated as not loaded.
+    if (&dataSrc == &sImage) {
+        sCheckpoint.Valid = !loadComplete;
+        sCheckpoint.ClearDone = (curSrc == &skipSrc);
+        sCheckpoint.WordsLoaded = (curSrc == imageSrc)
+            ? wordsIssued - MIN(wordsIssued, (uint32_t)m93xxCtr.UnconfirmedCommandCount())
+            : 0;
+    }
+
+    Core1::ResumeForwarding();
+
+    return loadComplete;
+}
+
+uint32_t EstimateLoadTimeMS(LoadDataSource& dataSrc, uint32_t& cmdCount, uint32_t& charCount)
+{
+    uint16_t nextDepositAddr = M93xxController::kUnknownAddress;
+    uint16_t data, addr;
+    const uint8_t * runData;
+    size_t runLen;
+
+    cmdCount = 0;
+    charCount = 0;
+
+    // Walk the data source, mirroring the sequence of commands issued by
+    // LoadFileMode() and totaling their lengths.
+    dataSrc.Rewind();
+    while (!dataSrc.AtEnd() && dataSrc.GetRun(addr, runData, runLen)) {
+        if (nextDepositAddr != addr) {
+            charCount += M93xxController::SetAddressCmdLen(addr);
+            cmdCount++;
+        }
+        for (size_t i = 0; i < runLen; i += 2) {
+            data = runData[i];
+            if (i + 1 < runLen) {
+                data |= (uint16_t)(runData[i + 1] << 8);
+            }
+            charCount += M93xxController::DepositCmdLen(data);
+            cmdCount++;
+        }
+        nextDepositAddr = (uint16_t)(addr + ((runLen + 1) & ~(size_t)1));
+        dataSrc.AdvanceRun(runLen);
+    }
+    if (dataSrc.GetStartAddress() != NO_ADDR) {
+        charCount += M93xxController::SetAddressCmdLen(dataSrc.GetStartAddress());
+        cmdCount++;
+    }
+    dataSrc.Rewind();
+
+    // Estimate the load time from the number of characters output by the
+    // console, which includes the echoed commands plus the response to each.
+    uint64_t estTimeUS = (uint64_t)(charCount + cmdCount * M93xxController::kResponseOverhead)
+                         * gSCLPort.GetConfig().CharTimeUS();
+    return (uint32_t)(estTimeUS / 1000);
+}
+
+uint32_t EstimateVerifyTimeMS(LoadDataSource& dataSrc)
+{
+    uint16_t addr, nextExamineAddr = NO_ADDR;
+    const uint8_t * runData;
+    size_t runLen;
+    uint64_t charCount = 0;
+
+    // Walk the data source, mirroring the sequence of commands issued by
+    // LoadVerifier and totaling the console output for each.
+    dataSrc.Rewind();
+    while (!dataSrc.AtEnd() && dataSrc.GetRun(addr, runData, runLen)) {
+        if (nextExamineAddr != addr) {
+            charCount += M93xxController::SetAddressCmdLen(addr) + M93xxController::kResponseOverhead;
+        }
+        charCount += ((runLen + 1) / 2) * M93xxController::kExamineOutputLen;
+        nextExamineAddr = (uint16_t)(addr + ((runLen + 1) & ~(size_t)1));
+        dataSrc.AdvanceRun(runLen);
+    }
+    dataSrc.Rewind();
+
+    return (uint32_t)((charCount * gSCLPort.GetConfig().CharTimeUS()) / 1000);
+}
+
+bool PlanMemoryClear(Port& uiPort, LoadDataSource& dataSrc, MemoryClearDataSource& clearSrc,
+                     ZeroSkipDataSource& skipSrc)
+{
+    uint32_t cmdCount, charCount;
+
+    if (!clearSrc.Plan(dataSrc)) {
+        return false;
+    }
+
+    // Compare the time needed to deposit the whole image with the time needed
+    // to deposit and run the memory clear routine and then deposit the
+    // remaining words.
+    uint32_t fullTimeMS = EstimateLoadTimeMS(dataSrc, cmdCount, charCount);
+    uint32_t clearTimeMS = EstimateLoadTimeMS(clearSrc, cmdCount, charCount) +
+        EstimateLoadTimeMS(skipSrc, cmdCount, charCount) +
+        (uint32_t)(((uint64_t)MemoryClearDataSource::kStartOverheadChars * gSCLPort.GetConfig().CharTimeUS()) / 1000);
+
+    // If verifying, include the time needed to verify the image in each case.
+    // Cleared ranges are only spot-checked.
+    if (Settings::VerifyLoad != Settings::VerifyLoad_Off) {
+        fullTimeMS += EstimateVerifyTimeMS(dataSrc);
+        clearTimeMS += EstimateVerifyTimeMS(skipSrc) + SpotCheckTimeMS(clearSrc);
+    }
+    if (clearTimeMS >= fullTimeMS) {
+        return false;
+    }
+
+    uiPort.Printf(TITLE_PREFIX "ZERO RUNS: clearing %" PRIu32 " words in %u ranges, saves about %" PRIu32 " seconds (%" PRIu32 "%%)\r\n",
+                  clearSrc.ClearedWordCount(), (unsigned)clearSrc.RangeCount(),
+                  (fullTimeMS - clearTimeMS + 999) / 1000,
+                  (uint32_t)(((uint64_t)(fullTimeMS - clearTimeMS) * 100) / fullTimeMS));
+
+    return true;
+}
+
+uint32_t SpotCheckTimeMS(const MemoryClearDataSource& clearSrc)
+{
+    // Each cleared range is spot-checked by examining its first and last
+    // words, each preceded by a set address command.
+    uint64_t charCount = (uint64_t)clearSrc.RangeCount() * 2 *
+        (M93xxController::SetAddressCmdLen(0177776) + M93xxController::kResponseOverhead +
+         M93xxController::kExamineOutputLen);
+    return (uint32_t)((charCount * gSCLPort.GetConfig().CharTimeUS()) / 1000);
+}
+
+uint32_t SkipWords(LoadDataSource& dataSrc, uint32_t wordCount)
+{
+    uint32_t skipped = 0;
+    uint16_t addr;
+    const uint8_t * data;
+    size_t len;
 
-        // Advance the data source to the next word
-        dataSrc.Advance();
+    dataSrc.Rewind();
+    while (skipped < wordCount && !dataSrc.AtEnd() && dataSrc.GetRun(addr, data, len)) {
+        uint32_t runWords = MIN((uint32_t)((len + 1) / 2), wordCount - skipped);
+        dataSrc.AdvanceRun(runWords * 2);
+        skipped += runWords;
     }
+    return skipped;
 }
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+
+#include "ConsoleAdapter.h"
+#include "M93xxController.h"
+#include "MemoryClear.h"
+#include "LoadVerifier.h"
+
+LoadVerifier::LoadVerifier(M93xxController& m93xxCtr, LoadDataSource& dataSrc, bool repair)
+: mState(kIdle), mM93xxCtr(m93xxCtr), mDataSrc(dataSrc), mClearSrc(NULL), mRepair(repair),
+  mRunAddr(0), mRunData(NULL), mRunLen(0), mRunPos(0),
+  mWordCount(0), mSkippedCount(0), mMismatchCount(0), mRepairedCount(0),
+  mMismatchIndex(0), mRecordedCount(0), mPendingHead(0), mPendingCount(0)
+{
+}
+
+void LoadVerifier::SpotCheckCleared(const MemoryClearDataSource& clearSrc)
+{
+    mClearSrc = &clearSrc;
+}
+
+void LoadVerifier::Begin(void)
+{
+    mDataSrc.Rewind();
+    mRunLen = mRunPos = 0;
+    mWordCount = mSkippedCount = mMismatchCount = mRepairedCount = 0;
+    mMismatchIndex = mRecordedCount = 0;
+    mPendingHead = mPendingCount = 0;
+    mState = kVerify;
+
+    // Discard the results of any earlier examine commands.
+    uint16_t addr, val;
+    while (mM93xxCtr.GetExamineResult(addr, val))
+        ;
+}
+
+void LoadVerifier::Step(Port& uiPort)
+{
+    uint16_t addr, data;
+
+    // Check the results of any examine commands the console has completed.
+    CheckResults(uiPort);
+
+    switch (mState) {
+    case kVerify:
+
+        // Examine the next word to be verified, once there is room to do so.
+        if (NextVerifyWord(addr, data)) {
+            if (QueueExamine(addr, data)) {
+                mRunPos += 2;
+                mWordCount++;
+            }
+            return;
+        }
+
+        // Wait for the console to respond to the remaining examines.
+        if (mPendingCount > 0) {
+            return;
+        }
+
+        if (mSkippedCount > 0) {
+            uiPort.Printf(TITLE_PREFIX "VERIFY: %" PRIu32 " words, %" PRIu32 " mismatches (%" PRIu32 " cleared words not examined)\r\n",
+                          mWordCount, mMismatchCount, mSkippedCount);
+        }
+        else {
+            uiPort.Printf(TITLE_PREFIX "VERIFY: %" PRIu32 " words, %" PRIu32 " mismatches\r\n",
+                          mWordCount, mMismatchCount);
+        }
+
+        // If repairing, and all mismatches were recorded, re-deposit the
+        // mismatched words.
+        if (mRepair && mMismatchCount > 0 && mRecordedCount == mMismatchCount) {
+            uiPort.Write(TITLE_PREFIX "RE-DEPOSITING MISMATCHED WORDS\r\n");
+            mMismatchIndex = 0;
+            mState = kRepair;
+        }
+        else {
+            mState = kDone;
+            return;
+        }
+
+        /* fall thru */
+
+    case kRepair:
+
+        // Re-deposit each mismatched word.
+        if (mMismatchIndex < mRecordedCount) {
+            const Mismatch& mismatch = mMismatches[mMismatchIndex];
+            if (!mM93xxCtr.CanQueueCommand()) {
+                return;
+            }
+            if (mM93xxCtr.NextDepositAddress() != mismatch.Addr) {
+                mM93xxCtr.SetAddress(mismatch.Addr);
+                return;
+            }
+            mM93xxCtr.Deposit(mismatch.Data);
+            mMismatchIndex++;
+            return;
+        }
+        mMismatchIndex = 0;
+        mState = kRecheck;
+
+        /* fall thru */
+
+    case kRecheck:
+
+        // Examine each re-deposited word again.
+        if (mMismatchIndex < mRecordedCount) {
+            const Mismatch& mismatch = mMismatches[mMismatchIndex];
+            if (QueueExamine(mismatch.Addr, mismatch.Data)) {
+                mMismatchIndex++;
+            }
+            return;
+        }
+        if (mPendingCount > 0) {
+            return;
+        }
+
+        uiPort.Printf(TITLE_PREFIX "VERIFY: %" PRIu32 " of %" PRIu32 " mismatched words repaired\r\n",
+                      mRepairedCount, mMismatchCount);
+        mState = kDone;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void LoadVerifier::CheckResults(Port& uiPort)
+{
+    uint16_t addr, val;
+
+    // The console responds to examine commands in the order they were issued,
+    // so each result is compared against the oldest pending check.  A result
+    // for a different address (e.g. because the examine faulted) counts as a
+    // mismatch.
+    while (mPendingCount > 0 && mM93xxCtr.GetExamineResult(addr, val)) {
+        const PendingCheck check = mPending[mPendingHead];
+        mPendingHead = (mPendingHead + 1) % kMaxPendingChecks;
+        mPendingCount--;
+
+        bool match = (addr == check.Addr && val == check.Data);
+
+        if (mState == kRecheck) {
+            if (match) {
+                mRepairedCount++;
+            }
+            else {
+                uiPort.Printf(TITLE_PREFIX "REPAIR FAILED at %06" PRIo16 "\r\n", check.Addr);
+            }
+            continue;
+        }
+
+        if (!match) {
+            if (addr == check.Addr) {
+                uiPort.Printf(TITLE_PREFIX "VERIFY MISMATCH at %06" PRIo16 ": expected %06" PRIo16 ", read %06" PRIo16 "\r\n",
+                              check.Addr, check.Data, val);
+            }
+            else {
+                uiPort.Printf(TITLE_PREFIX "VERIFY MISMATCH at %06" PRIo16 ": expected %06" PRIo16 ", could not examine\r\n",
+                              check.Addr, check.Data);
+            }
+            if (mRecordedCount < kMaxMismatches) {
+                mMismatches[mRecordedCount++] = { check.Addr, check.Data };
+            }
+            mMismatchCount++;
+        }
+    }
+}
+
+bool LoadVerifier::QueueExamine(uint16_t addr, uint16_t data)
+{
+    // Wait until the pipeline can accept another command and the response
+    // to the examine can be tracked.
+    if (mPendingCount >= kMaxPendingChecks || !mM93xxCtr.CanQueueCommand()) {
+        return false;
+    }
+
+    // Set the examine address first if it doesn't follow on from the
+    // previous examine.
+    if (mM93xxCtr.NextExamineAddress() != addr) {
+        mM93xxCtr.SetAddress(addr);
+        return false;
+    }
+
+    mM93xxCtr.Examine();
+    mPending[(mPendingHead + mPendingCount) % kMaxPendingChecks] = { addr, data };
+    mPendingCount++;
+    return true;
+}
+
+bool LoadVerifier::NextVerifyWord(uint16_t& addr, uint16_t& data)
+{
+    while (true) {
+
+        // If the current run has been verified, move to the next run.
+        if (mRunPos >= mRunLen) {
+            if (mRunLen > 0) {
+                mDataSrc.AdvanceRun(mRunLen);
+                mRunLen = mRunPos = 0;
+            }
+            if (mDataSrc.AtEnd() || !mDataSrc.GetRun(mRunAddr, mRunData, mRunLen) || mRunLen == 0) {
+                return false;
+            }
+        }
+
+        // Skip words in the interior of ranges cleared by the memory clear
+        // routine.
+        addr = (uint16_t)(mRunAddr + mRunPos);
+        if (mClearSrc == NULL || !mClearSrc->IsClearedInterior(addr)) {
+            break;
+        }
+        mRunPos += 2;
+        mSkippedCount++;
+    }
+
+    data = mRunData[mRunPos];
+    if (mRunPos + 1 < mRunLen) {
+        data |= (uint16_t)(mRunData[mRunPos + 1] << 8);
+    }
+    return true;
+}
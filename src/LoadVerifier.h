@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOAD_VERIFIER_H
+#define LOAD_VERIFIER_H
+
+class M93xxController;
+class MemoryClearDataSource;
+
+/** Verifies the contents of PDP-11 memory against a loaded data source by
+ *  examining memory via the M9301/M9312 console
+ *
+ * Each run of words is examined using the console's auto-increment feature,
+ * such that each word costs a single "E " command.  Examine commands are
+ * queued in the controller's pipeline, with the expected address and value
+ * of each held until the console's response arrives.  Optionally, words that
+ * don't match are re-deposited and examined again.  Ranges cleared by a
+ * memory clear routine are spot-checked, by examining only the first and last
+ * word of each range.
+ */
+class LoadVerifier final
+{
+public:
+    LoadVerifier(M93xxController& m93xxCtr, LoadDataSource& dataSrc, bool repair);
+    ~LoadVerifier() = default;
+    LoadVerifier(const LoadVerifier&) = delete;
+
+    void SpotCheckCleared(const MemoryClearDataSource& clearSrc);
+    void Begin(void);
+    void Step(Port& uiPort);
+    bool IsDone(void) const;
+    bool Succeeded(void) const;
+
+private:
+    enum {
+        kIdle,
+        kVerify,
+        kRepair,
+        kRecheck,
+        kDone
+    } mState;
+    M93xxController& mM93xxCtr;
+    LoadDataSource& mDataSrc;
+    const MemoryClearDataSource * mClearSrc;
+    const bool mRepair;
+    uint16_t mRunAddr;
+    const uint8_t * mRunData;
+    size_t mRunLen, mRunPos;
+    uint32_t mWordCount;
+    uint32_t mSkippedCount;
+    uint32_t mMismatchCount;
+    uint32_t mRepairedCount;
+
+    // Mismatched words recorded for re-depositing
+    struct Mismatch
+    {
+        uint16_t Addr;
+        uint16_t Data;
+    };
+    static constexpr size_t kMaxMismatches = 32;
+    Mismatch mMismatches[kMaxMismatches];
+    size_t mMismatchIndex;
+    size_t mRecordedCount;
+
+    // Examine commands awaiting a response from the console, in the order
+    // issued
+    struct PendingCheck
+    {
+        uint16_t Addr;
+        uint16_t Data;
+    };
+    static constexpr size_t kMaxPendingChecks = 4;
+    PendingCheck mPending[kMaxPendingChecks];
+    size_t mPendingHead;
+    size_t mPendingCount;
+
+    void CheckResults(Port& uiPort);
+    bool QueueExamine(uint16_t addr, uint16_t data);
+    bool NextVerifyWord(uint16_t& addr, uint16_t& data);
+};
+
+inline bool LoadVerifier::IsDone(void) const
+{
+    return mState == kIdle || mState == kDone;
+}
+
+inline bool LoadVerifier::Succeeded(void) const
+{
+    return mMismatchCount == mRepairedCount;
+}
+
+#endif // LOAD_VERIFIER_H
@@ -42,25 +42,93 @@ inline uint64_t time_us_64() { return gCurTime; }
 
 #include "M93xxController.h"
 
+uint32_t M93xxController::sObservedGapUS;
+uint32_t M93xxController::sObservedCharTimeUS;
+
+static size_t OctalDigits(uint16_t val)
+{
+    size_t digits = 1;
+    while ((val >>= 3) != 0) {
+        digits++;
+    }
+    return digits;
+}
+
+static size_t FormatCommand(char * buf, size_t bufSize, char cmd, uint16_t val)
+{
+    // Send the value with leading zeros suppressed to minimize the
+    // number of characters sent over the (often slow) SCL port.
+    return (size_t)snprintf(buf, bufSize, "%c %" PRIo16 "\r", cmd, val);
+}
+
 void M93xxController::Reset(void)
 {
     mState = kStart;
     mLastCmd = 0;
     mLastAddr = kUnknownAddress;
     mLastVal = 0;
+    mLastCmdFaulted = false;
+    mPipeHead = 0;
+    mPipeCount = 0;
+    mTxCmd = mTxPos = 0;
+    mEchoCmd = mEchoPos = 0;
+    mResponsePos = 0;
+    mOutstanding = 0;
+    mPipelineState = kPipelineNormal;
+    mReplayAddrSent = false;
+    mLockStepPending = false;
+    mExamineResultHead = 0;
+    mExamineResultCount = 0;
+    mResyncWithSync = false;
+    mRecoveryAttempts = 0;
+    mErrorCount = 0;
+    mRecoveryCount = 0;
+    mLastOutputTime = 0;
     CancelPromptTimeout();
     CancelIdleTimeout();
 }
 
 bool M93xxController::ProcessOutput(char ch)
 {
-    // Fail if the character is not something we expect the M9301/M9312
-    // console to output.  This may indicate that we're not talking to a
-    // console or that the serial configuration is wrong.
-    if (!IsValidOutputChar(ch)) {
-        return false;
+    // While resynchronizing, wait for the console to go quiet, ignoring any
+    // garbled output.
+    if (mPipelineState == kPipelineResync) {
+        ArmIdleTimeout();
+        if (!IsValidOutputChar(ch)) {
+            return true;
+        }
     }
 
+    // While re-establishing contact with the console, ignore garbled output.
+    else if (mPipelineState == kPipelineSync) {
+        if (!IsValidOutputChar(ch)) {
+            return true;
+        }
+    }
+
+    // If the character is not something we expect the M9301/M9312 console
+    // to output (e.g. due to line noise), resynchronize with the console and
+    // retry the command in progress.  Fail if this happens before contact
+    // has been established with the console, which may indicate that we're
+    // not talking to a console or that the serial configuration is wrong,
+    // or if recovery fails repeatedly.
+    else if (!IsValidOutputChar(ch)) {
+        return BeginRecovery();
+    }
+
+    // If commands are being pipelined, verify that the character is the
+    // next one expected from the console.  If not, stop pipelining and
+    // resynchronize with the console.
+    else if (mPipelineState == kPipelineNormal && mPipeCount > 0) {
+        if (!MatchPipelineOutput(ch)) {
+            mErrorCount++;
+            BeginResync();
+        }
+    }
+
+    // Keep track of how quickly the console outputs characters.
+    RecordOutputGap();
+
     switch (mState) {
     case kWaitingForSyncChar:
 
@@ -85,16 +153,46 @@ bool M93xxController::ProcessOutput(char ch)
 
     case kWaitingForPrompt:
 
+        // If the console outputs digits after responding to a set address,
+        // examine or deposit command, the command caused a bus error (e.g. by
+        // accessing non-existent memory), and the console has trapped and
+        // restarted, dumping the registers as it does when first entered.
+        // Note the fault, and that the console's current address is now
+        // unknown.
+        if (ch >= '0' && ch <= '7' && mState == kWaitingForPrompt &&
+            (mLastCmd == 'L' || mLastCmd == 'E' || mLastCmd == 'D')) {
+            mLastCmdFaulted = true;
+            mLastCmd = 0;
+            mLastAddr = kUnknownAddress;
+        }
+
         // Once we get a prompt character the console is ready for a command.
-        if (ch == '@' || ch == '$') {
+        // If the prompt follows a command, the command is now confirmed.
+        else if (ch == '@' || ch == '$') {
+            if (mState == kWaitingForPrompt) {
+                if (mLockStepPending && mLockStepCmd.Cmd == 'E') {
+                    RecordExamineResult();
+                }
+                mLockStepPending = false;
+                if (mPipelineState == kPipelineNormal) {
+                    mRecoveryAttempts = 0;
+                }
+            }
             mState = kReadyForCommand;
             CancelPromptTimeout();
+
+            // If contact has been re-established after garbled output,
+            // replay the unconfirmed commands.
+            if (mPipelineState == kPipelineSync) {
+                mPipelineState = kPipelineReplay;
+            }
         }
 
         break;
 
     case kReadyForCommand:
     case kWaitingForResponse:
+        mLastCmdFaulted = false;
         switch (ch) {
         case 'L':
             mLastCmd = ch;
@@ -175,11 +273,39 @@ bool M93xxController::ProcessOutput(char ch)
         break;
     }
 
+    // Send further pipelined commands now that the console has made progress.
+    PumpPipeline();
+
     return true;
 }
 
 bool M93xxController::ProcessTimeouts(void)
 {
+    // If resynchronizing after a pipeline error, wait for the console to be
+    // idle at a prompt and then replay the unconfirmed commands.  If the
+    // console goes quiet without issuing a prompt, it may be in the middle
+    // of a partially received command, so send a CR to complete it.
+    //
+    // When recovering from garbled output, the console's state is unknown, so
+    // instead re-establish contact using the same sync character handshake
+    // used when first contacting the console.
+    if (mPipelineState == kPipelineResync && IdleTimeoutExpired()) {
+        if (mResyncWithSync) {
+            gSCLPort.Write(kSyncChar);
+            mState = kWaitingForSyncChar;
+            mPipelineState = kPipelineSync;
+            ArmPromptTimeout();
+        }
+        else if (mState == kReadyForCommand) {
+            mPipelineState = kPipelineReplay;
+            PumpPipeline();
+        }
+        else {
+            gSCLPort.Write('\r');
+            ArmIdleTimeout();
+        }
+    }
+
     switch (mState) {
     case kStart:
 
@@ -230,39 +356,120 @@ bool M93xxController::ProcessTimeouts(void)
     }
 }
 
+void M93xxController::SetCharTime(uint32_t charTimeUS)
+{
+    mCharTimeUS = charTimeUS;
+
+    // Start from the gap observed in the previous session, provided it was
+    // measured at the same character time.
+    mMaxGapUS = (charTimeUS == sObservedCharTimeUS) ? sObservedGapUS : 0;
+}
+
+uint32_t M93xxController::IdleTimeoutUS(void) const
+{
+    if (mCharTimeUS == 0) {
+        return kIdleTimeoutUS;
+    }
+    uint32_t timeoutUS = kIdleTimeoutChars * CharIntervalUS();
+    return (timeoutUS > kMinIdleTimeoutUS) ? timeoutUS : kMinIdleTimeoutUS;
+}
+
+uint32_t M93xxController::PromptTimeoutUS(void) const
+{
+    if (mCharTimeUS == 0) {
+        return kPromptTimeoutUS;
+    }
+    uint32_t timeoutUS = kPromptTimeoutChars * CharIntervalUS();
+    return (timeoutUS > kMinPromptTimeoutUS) ? timeoutUS : kMinPromptTimeoutUS;
+}
+
+void M93xxController::RecordOutputGap(void)
+{
+    uint64_t now = time_us_64();
+
+    // Measure the gap between successive characters output while the console
+    // is responding to a set address, examine or deposit command, excluding
+    // the gap before the first character, which includes the time taken to
+    // issue the command.  Ignore output while recovering from errors.
+    if (mCharTimeUS != 0 && mLastOutputTime != 0 &&
+        (mState == kParsingAddr || mState == kParsingValue || mState == kWaitingForPrompt) &&
+        (mLastCmd == 'L' || mLastCmd == 'E' || mLastCmd == 'D') &&
+        (mPipelineState == kPipelineNormal || mPipelineState == kPipelineReplay)) {
+        uint64_t gapUS = now - mLastOutputTime;
+        if (gapUS > (uint64_t)kMaxGapChars * mCharTimeUS) {
+            gapUS = (uint64_t)kMaxGapChars * mCharTimeUS;
+        }
+        if (gapUS > mMaxGapUS) {
+            mMaxGapUS = (uint32_t)gapUS;
+            sObservedGapUS = (uint32_t)gapUS;
+            sObservedCharTimeUS = mCharTimeUS;
+        }
+    }
+
+    mLastOutputTime = now;
+}
+
 void M93xxController::SetAddress(uint16_t addr)
 {
-    if (mState == kReadyForCommand) {
-        char loadCmd[10];
-        snprintf(loadCmd, sizeof(loadCmd), "L %06" PRIo16 "\r", addr);
-        gSCLPort.Write(loadCmd);
-        mState = kWaitingForResponse;
+    if (IsPipelined() && CanQueueCommand()) {
+        QueueCommand('L', addr, addr);
+    }
+    else if (IsReadyForCommand()) {
+        SendCommand('L', addr, addr);
     }
 }
 
 void M93xxController::Deposit(uint16_t val)
 {
-    if (mState == kReadyForCommand) {
-        char depositCmd[10];
-        snprintf(depositCmd, sizeof(depositCmd), "D %06" PRIo16 "\r", val);
-        gSCLPort.Write(depositCmd);
-        mState = kWaitingForResponse;
+    if (IsPipelined() && CanQueueCommand()) {
+        QueueCommand('D', val, NextDepositAddress());
+    }
+    else if (IsReadyForCommand()) {
+        SendCommand('D', val, NextDepositAddress());
     }
 }
 
 void M93xxController::Examine(void)
 {
-    if (mState == kReadyForCommand) {
-        gSCLPort.Write("E ");
-        mState = kWaitingForResponse;
+    if (IsPipelined() && CanQueueCommand()) {
+        QueueCommand('E', 0, NextExamineAddress());
+    }
+    else if (IsReadyForCommand()) {
+        SendCommand('E', 0, NextExamineAddress());
+    }
+}
+
+bool M93xxController::GetExamineResult(uint16_t& addr, uint16_t& val)
+{
+    if (mExamineResultCount == 0) {
+        return false;
+    }
+    const ExamineResult& result = mExamineResults[mExamineResultHead];
+    addr = result.Addr;
+    val = result.Val;
+    mExamineResultHead = (mExamineResultHead + 1) % kMaxExamineResults;
+    mExamineResultCount--;
+    return true;
+}
+
+void M93xxController::RecordExamineResult(void)
+{
+    // Record the address and value of a confirmed examine command.  If the
+    // examine faulted, the address is unknown.  Results are discarded if
+    // they are not collected (e.g. by callers that only use LastAddress()
+    // and LastExamineValue()).
+    if (mExamineResultCount < kMaxExamineResults) {
+        ExamineResult& result = mExamineResults[(mExamineResultHead + mExamineResultCount) % kMaxExamineResults];
+        result.Addr = (mLastCmd == 'E') ? mLastAddr : kUnknownAddress;
+        result.Val = mLastVal;
+        mExamineResultCount++;
     }
 }
 
 void M93xxController::Start(void)
 {
-    if (mState == kReadyForCommand) {
-        gSCLPort.Write("S\r");
-        mState = kWaitingForResponse;
+    if (IsReadyForCommand()) {
+        SendCommand('S', 0, kUnknownAddress);
     }
 }
 
@@ -271,6 +478,229 @@ void M93xxController::SendCR(void)
     gSCLPort.Write('\r');
 }
 
+bool M93xxController::CanQueueCommand(void) const
+{
+    // When not pipelining, or when recovering from a pipeline error, commands
+    // are issued one at a time.
+    if (!IsPipelined() || mPipelineState != kPipelineNormal) {
+        return IsReadyForCommand();
+    }
+
+    // Otherwise commands can be queued once the console has been contacted,
+    // provided there is room in the pipeline.
+    return mPipeCount < kPipelineDepth &&
+           mState != kStart && mState != kWaitingForSyncChar && mState != kWaitingForInitialPrompt;
+}
+
+void M93xxController::InitCommand(PipelineCmd& entry, char cmd, uint16_t val, uint16_t addr)
+{
+    switch (cmd) {
+    case 'E':
+        entry.Len = (uint8_t)snprintf(entry.Text, sizeof(entry.Text), "E ");
+        break;
+    case 'S':
+        entry.Len = (uint8_t)snprintf(entry.Text, sizeof(entry.Text), "S\r");
+        break;
+    default:
+        entry.Len = (uint8_t)FormatCommand(entry.Text, sizeof(entry.Text), cmd, val);
+        break;
+    }
+    entry.Cmd = cmd;
+    entry.Addr = addr;
+}
+
+void M93xxController::SendCommand(char cmd, uint16_t val, uint16_t addr)
+{
+    // Send a single command, remembering it in case it needs to be replayed.
+    InitCommand(mLockStepCmd, cmd, val, addr);
+    gSCLPort.Write(mLockStepCmd.Text);
+    mLockStepPending = true;
+    mState = kWaitingForResponse;
+}
+
+void M93xxController::QueueCommand(char cmd, uint16_t val, uint16_t addr)
+{
+    PipelineCmd& entry = PipeEntry(mPipeCount);
+    InitCommand(entry, cmd, val, addr);
+    mPipeCount++;
+
+    PumpPipeline();
+}
+
+void M93xxController::PumpPipeline(void)
+{
+    switch (mPipelineState) {
+    case kPipelineNormal:
+
+        // Send queued command characters for as long as the number of
+        // characters the console has yet to output in response stays within
+        // the pipeline window.  Each character sent will be echoed by the
+        // console, and each CR will additionally produce a LF and a new prompt.
+        //
+        // Limiting the outstanding output, rather than the number of
+        // commands, ensures that the console's single character receive
+        // buffer can never overrun while it is busy printing a prompt.
+        while (mTxCmd < mPipeCount && mOutstanding < mPipelineWindow) {
+            PipelineCmd& cmd = PipeEntry(mTxCmd);
+            char ch = cmd.Text[mTxPos];
+            gSCLPort.Write(ch);
+            mOutstanding += (ch == '\r') ? 1 + kResponseOverhead : 1;
+            if (++mTxPos == cmd.Len) {
+
+                // The console responds to an examine command, which has no
+                // terminating CR, by printing the address and value examined,
+                // followed by a CR, a LF and a new prompt.
+                if (cmd.Cmd == 'E') {
+                    mOutstanding += kExamineResponseLen + kResponseOverhead;
+                }
+                mTxCmd++;
+                mTxPos = 0;
+            }
+        }
+        break;
+
+    case kPipelineReplay:
+
+        // Re-issue unconfirmed commands one at a time, waiting for the console
+        // to respond to each.  If the first command to be replayed is a deposit
+        // or examine, precede it with a set address command, since the console's
+        // notion of the current address cannot be trusted.
+        if (mState == kReadyForCommand) {
+            if (mPipeCount == 0) {
+                mPipelineState = kPipelineNormal;
+                break;
+            }
+            PipelineCmd& cmd = PipeEntry(0);
+            if ((cmd.Cmd == 'D' || cmd.Cmd == 'E') && cmd.Addr != kUnknownAddress && !mReplayAddrSent) {
+                char loadCmd[10];
+                FormatCommand(loadCmd, sizeof(loadCmd), 'L', cmd.Addr);
+                gSCLPort.Write(loadCmd);
+            }
+            else {
+                mLockStepCmd = cmd;
+                mLockStepPending = true;
+                gSCLPort.Write(cmd.Text);
+                mPipeHead = (mPipeHead + 1) % kPipelineDepth;
+                mPipeCount--;
+            }
+            mReplayAddrSent = true;
+            mState = kWaitingForResponse;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+bool M93xxController::MatchPipelineOutput(char ch)
+{
+    // Following the echo of a command's terminating CR, the console outputs
+    // a LF and then a new prompt.  Once the prompt arrives, the command at
+    // the head of the pipeline is complete.  For an examine command, the
+    // echo is followed by the console's response, which ends with a CR.
+    if (mEchoCmd > 0) {
+        if (PipeEntry(0).Cmd == 'E' && mResponsePos < kExamineResponseLen) {
+            if ((ch >= '0' && ch <= '7') || ch == ' ' || ch == '\r') {
+                mResponsePos++;
+                mOutstanding--;
+                return true;
+            }
+            return false;
+        }
+        if (ch == '\n') {
+            return true;
+        }
+        if (ch == '@' || ch == '$') {
+            if (PipeEntry(0).Cmd == 'E') {
+                RecordExamineResult();
+            }
+            mResponsePos = 0;
+            mPipeHead = (mPipeHead + 1) % kPipelineDepth;
+            mPipeCount--;
+            mEchoCmd--;
+            mTxCmd--;
+            mOutstanding -= kResponseOverhead;
+            return true;
+        }
+        return false;
+    }
+
+    // Otherwise the character should be the echo of the next character sent.
+    if (mEchoCmd < mTxCmd || mEchoPos < mTxPos) {
+        PipelineCmd& cmd = PipeEntry(mEchoCmd);
+        if (ch != cmd.Text[mEchoPos]) {
+            return false;
+        }
+        mOutstanding--;
+        if (++mEchoPos == cmd.Len) {
+            mEchoCmd++;
+            mEchoPos = 0;
+        }
+        return true;
+    }
+
+    // Fail if the console output something that wasn't expected.
+    return false;
+}
+
+void M93xxController::BeginResync(void)
+{
+    // Abandon pipelined operation for the remainder of the session.  Commands
+    // that have not been confirmed by the console remain in the pipeline to
+    // be replayed once the console is ready.
+    mPipelineWindow = 0;
+    mPipelineState = kPipelineResync;
+    mTxCmd = mTxPos = 0;
+    mEchoCmd = mEchoPos = 0;
+    mResponsePos = 0;
+    mOutstanding = 0;
+    mReplayAddrSent = false;
+    mResyncWithSync = false;
+    mRecoveryCount++;
+    ArmIdleTimeout();
+}
+
+bool M93xxController::BeginRecovery(void)
+{
+    mErrorCount++;
+
+    // Fail if contact has not yet been established with the console, or if
+    // recovery has failed repeatedly.  Also fail if a start command was in
+    // progress, since it isn't safe to replay it.
+    if (mState == kStart || mState == kWaitingForSyncChar || mState == kWaitingForInitialPrompt ||
+        (mLockStepPending && mLockStepCmd.Cmd == 'S') ||
+        ++mRecoveryAttempts > kMaxRecoveryAttempts) {
+        return false;
+    }
+
+    // Return any command sent outside of the pipeline to the head of the
+    // pipeline, so that it is replayed once contact has been re-established.
+    if (mLockStepPending) {
+        mPipeHead = (mPipeHead + kPipelineDepth - 1) % kPipelineDepth;
+        mPipe[mPipeHead] = mLockStepCmd;
+        mPipeCount++;
+        mLockStepPending = false;
+    }
+
+    // Wait for the console to go quiet and then re-establish contact.
+    BeginResync();
+    mResyncWithSync = true;
+    return true;
+}
+
+size_t M93xxController::SetAddressCmdLen(uint16_t addr)
+{
+    // "L " + octal address + CR
+    return 3 + OctalDigits(addr);
+}
+
+size_t M93xxController::DepositCmdLen(uint16_t val)
+{
+    // "D " + octal value + CR
+    return 3 + OctalDigits(val);
+}
+
 bool M93xxController::IsValidOutputChar(char ch)
 {
     static const char kValidChars[] = { 
@@ -315,6 +745,52 @@ void DriveController(M93xxController& c, const char * &p)
     }
 }
 
+/** Simulate an M9312 console, echoing the characters sent by the controller
+ *  (starting at position outPos) and following each CR with a LF and a prompt.
+ *  If dropPos is set, the character at that position is lost.
+ */
+void SimulateConsole(M93xxController& c, size_t& outPos, size_t dropPos = SIZE_MAX)
+{
+    while (outPos < gSCLPort.Output.length()) {
+        size_t pos = outPos++;
+        char ch = gSCLPort.Output[pos];
+        if (pos == dropPos) {
+            continue;
+        }
+        c.ProcessOutput(ch);
+        if (ch == '\r') {
+            c.ProcessOutput('\n');
+            c.ProcessOutput('@');
+        }
+    }
+}
+
+/** Simulate an M9312 console as above, additionally responding to each examine
+ *  command by printing the address examined (starting at examineAddr) and
+ *  the complement of the address as the value.
+ */
+void SimulateExamineConsole(M93xxController& c, size_t& outPos, uint16_t& examineAddr)
+{
+    char resp[20];
+
+    while (outPos < gSCLPort.Output.length()) {
+        size_t pos = outPos++;
+        char ch = gSCLPort.Output[pos];
+        c.ProcessOutput(ch);
+        if (ch == '\r') {
+            c.ProcessOutput('\n');
+            c.ProcessOutput('@');
+        }
+        else if (ch == ' ' && pos > 0 && gSCLPort.Output[pos - 1] == 'E') {
+            snprintf(resp, sizeof(resp), "%06o %06o \r\n@", examineAddr, (uint16_t)~examineAddr);
+            for (const char * p = resp; *p != 0; p++) {
+                c.ProcessOutput(*p);
+            }
+            examineAddr += 2;
+        }
+    }
+}
+
 #define TEST_ASSERT(TST) \
 { \
     if (!(TST)) { \
@@ -639,13 +1115,13 @@ bool Test3(void)
     InitController(c);
     gSCLPort.Output.clear();
     c.SetAddress(010101);
-    TEST_ASSERT(gSCLPort.Output.compare("L 010101\r") == 0);
+    TEST_ASSERT(gSCLPort.Output.compare("L 10101\r") == 0);
     TEST_ASSERT(!c.IsReadyForCommand());
 
     InitController(c);
     gSCLPort.Output.clear();
     c.SetAddress(0);
-    TEST_ASSERT(gSCLPort.Output.compare("L 000000\r") == 0);
+    TEST_ASSERT(gSCLPort.Output.compare("L 0\r") == 0);
     TEST_ASSERT(!c.IsReadyForCommand());
 
     InitController(c);
@@ -657,7 +1133,13 @@ bool Test3(void)
     InitController(c);
     gSCLPort.Output.clear();
     c.Deposit(042);
-    TEST_ASSERT(gSCLPort.Output.compare("D 000042\r") == 0);
+    TEST_ASSERT(gSCLPort.Output.compare("D 42\r") == 0);
+    TEST_ASSERT(!c.IsReadyForCommand());
+
+    InitController(c);
+    gSCLPort.Output.clear();
+    c.Deposit(0177777);
+    TEST_ASSERT(gSCLPort.Output.compare("D 177777\r") == 0);
     TEST_ASSERT(!c.IsReadyForCommand());
 
     InitController(c);
@@ -676,6 +1158,441 @@ bool Test3(void)
     return true;
 }
 
+/** Test 4 -- Command Length Prediction */
+bool Test4(void)
+{
+    static const uint16_t TestValues[] = {
+        0, 1, 7, 010, 077, 0100, 0777, 01000, 07777, 010000, 077777, 0100000, 0177777
+    };
+
+    M93xxController c;
+
+    printf("TEST4 ................. ");
+    fflush(stdout);
+
+    for (size_t i = 0; i < sizeof(TestValues) / sizeof(TestValues[0]); i++) {
+        InitController(c);
+        gSCLPort.Output.clear();
+        c.SetAddress(TestValues[i]);
+        TEST_ASSERT(gSCLPort.Output.length() == M93xxController::SetAddressCmdLen(TestValues[i]));
+
+        InitController(c);
+        gSCLPort.Output.clear();
+        c.Deposit(TestValues[i]);
+        TEST_ASSERT(gSCLPort.Output.length() == M93xxController::DepositCmdLen(TestValues[i]));
+    }
+
+    TEST_ASSERT(M93xxController::DepositCmdLen(0) == 4);
+    TEST_ASSERT(M93xxController::DepositCmdLen(0177777) == 9);
+
+    printf("PASS\n");
+
+    return true;
+}
+
+/** Test 5 -- Pipelined Commands */
+bool Test5(void)
+{
+    M93xxController c;
+    size_t outPos = 0;
+
+    printf("TEST5 ................. ");
+    fflush(stdout);
+
+    InitController(c);
+    gSCLPort.Output.clear();
+    c.SetPipelineWindow(3);
+    TEST_ASSERT(c.CanQueueCommand());
+
+    // Queue commands up to the depth of the pipeline
+    c.SetAddress(01000);
+    c.Deposit(1);
+    c.Deposit(2);
+    c.Deposit(03456);
+    TEST_ASSERT(!c.CanQueueCommand());
+    TEST_ASSERT(!c.IsReadyForCommand());
+    TEST_ASSERT(c.NextDepositAddress() == 01006);
+
+    // Only as many characters as fit in the window should have been sent
+    TEST_ASSERT(gSCLPort.Output.compare("L 1") == 0);
+
+    // Echo the first character; one more character should be sent
+    c.ProcessOutput(gSCLPort.Output[outPos++]);
+    TEST_ASSERT(gSCLPort.Output.compare("L 10") == 0);
+
+    // Echo up to and including the CR; the first character of the next
+    // command should be sent while the console is outputting its prompt
+    while (outPos < 7) {
+        c.ProcessOutput(gSCLPort.Output[outPos++]);
+    }
+    TEST_ASSERT(gSCLPort.Output.compare("L 1000\rD") == 0);
+    c.ProcessOutput('\n');
+    c.ProcessOutput('@');
+    TEST_ASSERT(c.CanQueueCommand());
+    TEST_ASSERT(c.LastCommand() == 'L');
+    TEST_ASSERT(c.LastAddress() == 01000);
+
+    // Run the console until all commands are complete
+    SimulateConsole(c, outPos);
+    TEST_ASSERT(gSCLPort.Output.compare("L 1000\rD 1\rD 2\rD 3456\r") == 0);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(c.LastCommand() == 'D');
+    TEST_ASSERT(c.LastAddress() == 01004);
+    TEST_ASSERT(c.LastExamineValue() == 03456);
+    TEST_ASSERT(c.NextDepositAddress() == 01006);
+    TEST_ASSERT(c.IsPipelined());
+
+    printf("PASS\n");
+
+    return true;
+}
+
+/** Test 6 -- Pipeline Error Recovery */
+bool Test6(void)
+{
+    M93xxController c;
+    size_t outPos = 0;
+
+    printf("TEST6 ................. ");
+    fflush(stdout);
+
+    InitController(c);
+    gSCLPort.Output.clear();
+    c.SetPipelineWindow(3);
+
+    c.SetAddress(02000);
+    c.Deposit(042);
+    c.Deposit(044);
+
+    // Lose the second digit of the first deposit value
+    SimulateConsole(c, outPos, 10);
+    TEST_ASSERT(!c.IsPipelined());
+    TEST_ASSERT(!c.CanQueueCommand());
+    TEST_ASSERT(!c.IsReadyForCommand());
+
+    // Once the console has been idle, the unconfirmed deposits should be
+    // replayed one at a time, preceded by a set address command
+    gCurTime += 250000;
+    c.ProcessTimeouts();
+    TEST_ASSERT(gSCLPort.Output.compare(outPos, std::string::npos, "L 2000\r") == 0);
+    SimulateConsole(c, outPos);
+    TEST_ASSERT(gSCLPort.Output.compare(outPos - 5, std::string::npos, "D 44\r") == 0);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(c.LastCommand() == 'D');
+    TEST_ASSERT(c.LastAddress() == 02002);
+    TEST_ASSERT(c.NextDepositAddress() == 02004);
+
+    // Subsequent commands should be issued in lock-step
+    size_t prevLen = gSCLPort.Output.length();
+    c.Deposit(046);
+    TEST_ASSERT(gSCLPort.Output.compare(prevLen, std::string::npos, "D 46\r") == 0);
+    TEST_ASSERT(!c.CanQueueCommand());
+
+    printf("PASS\n");
+
+    return true;
+}
+
+/** Test 7 -- Pipelined Examines */
+bool Test7(void)
+{
+    M93xxController c;
+    size_t outPos = 0;
+    uint16_t examineAddr = 01000;
+    uint16_t addr, val;
+
+    printf("TEST7 ................. ");
+    fflush(stdout);
+
+    InitController(c);
+    gSCLPort.Output.clear();
+    c.SetPipelineWindow(3);
+
+    // Queue examine commands up to the depth of the pipeline
+    c.SetAddress(01000);
+    c.Examine();
+    c.Examine();
+    c.Examine();
+    TEST_ASSERT(!c.CanQueueCommand());
+    TEST_ASSERT(c.NextExamineAddress() == 01006);
+    TEST_ASSERT(c.NextDepositAddress() == 01004);
+
+    // Echo the set address command and the first examine command; the
+    // second examine command should not be sent until the console has
+    // nearly finished responding to the first
+    while (outPos < 9) {
+        c.ProcessOutput(gSCLPort.Output[outPos++]);
+        if (outPos == 7) {
+            c.ProcessOutput('\n');
+            c.ProcessOutput('@');
+        }
+    }
+    TEST_ASSERT(gSCLPort.Output.compare("L 1000\rE ") == 0);
+    for (const char * p = "001000 176777 \r"; *p != 0; p++) {
+        c.ProcessOutput(*p);
+    }
+    TEST_ASSERT(gSCLPort.Output.compare("L 1000\rE E") == 0);
+    TEST_ASSERT(!c.GetExamineResult(addr, val));
+    c.ProcessOutput('\n');
+    c.ProcessOutput('@');
+    examineAddr += 2;
+
+    // The result of each examine command should be available once the
+    // console has issued its next prompt
+    TEST_ASSERT(c.GetExamineResult(addr, val));
+    TEST_ASSERT(addr == 01000 && val == 0176777);
+    TEST_ASSERT(!c.GetExamineResult(addr, val));
+
+    // Run the console until all commands are complete
+    SimulateExamineConsole(c, outPos, examineAddr);
+    TEST_ASSERT(gSCLPort.Output.compare("L 1000\rE E E ") == 0);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(c.GetExamineResult(addr, val));
+    TEST_ASSERT(addr == 01002 && val == 0176775);
+    TEST_ASSERT(c.GetExamineResult(addr, val));
+    TEST_ASSERT(addr == 01004 && val == 0176773);
+    TEST_ASSERT(!c.GetExamineResult(addr, val));
+    TEST_ASSERT(c.LastCommand() == 'E');
+    TEST_ASSERT(c.NextExamineAddress() == 01006);
+
+    // A bus error report in place of the examine response should stop
+    // pipelining without producing a result
+    c.Examine();
+    TEST_ASSERT(gSCLPort.Output.compare("L 1000\rE E E E ") == 0);
+    for (const char * p = "E \r\n000000 157776 000500 165212\r\n@"; *p != 0; p++) {
+        c.ProcessOutput(*p);
+    }
+    TEST_ASSERT(!c.IsPipelined());
+    TEST_ASSERT(!c.GetExamineResult(addr, val));
+
+    printf("PASS\n");
+
+    return true;
+}
+
+/** Test 8 -- Recovery From Garbled Console Output */
+bool Test8(void)
+{
+    M93xxController c;
+    size_t outPos = 0;
+
+    printf("TEST8 ................. ");
+    fflush(stdout);
+
+    // Garbled output before contact is established should fail immediately
+    c.Reset();
+    c.ProcessTimeouts();
+    TEST_ASSERT(!c.ProcessOutput('\xF7'));
+
+    InitController(c);
+    gSCLPort.Output.clear();
+
+    c.SetAddress(03000);
+    SimulateConsole(c, outPos);
+    TEST_ASSERT(c.IsReadyForCommand());
+
+    // Garble the echo of a deposit command
+    c.Deposit(0123);
+    TEST_ASSERT(c.ProcessOutput('D'));
+    TEST_ASSERT(c.ProcessOutput(' '));
+    TEST_ASSERT(c.ProcessOutput('\xF7'));
+    TEST_ASSERT(c.ProcessOutput('\x9C'));
+    outPos = gSCLPort.Output.length();
+    TEST_ASSERT(!c.IsReadyForCommand());
+    TEST_ASSERT(c.ErrorCount() == 1);
+
+    // Once the console has been idle, the sync handshake should be performed
+    gCurTime += 250000;
+    c.ProcessTimeouts();
+    TEST_ASSERT(gSCLPort.Output.compare(outPos, std::string::npos, ".") == 0);
+    outPos++;
+    TEST_ASSERT(c.ProcessOutput('.'));
+    TEST_ASSERT(c.ProcessOutput('@'));
+
+    // The deposit should then be replayed, preceded by a set address command
+    TEST_ASSERT(gSCLPort.Output.compare(outPos, std::string::npos, "L 3000\r") == 0);
+    SimulateConsole(c, outPos);
+    TEST_ASSERT(gSCLPort.Output.compare(outPos - 6, std::string::npos, "D 123\r") == 0);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(c.LastCommand() == 'D');
+    TEST_ASSERT(c.LastAddress() == 03000);
+    TEST_ASSERT(c.LastExamineValue() == 0123);
+    TEST_ASSERT(c.NextDepositAddress() == 03002);
+    TEST_ASSERT(c.RecoveryCount() == 1);
+
+    // An examine should likewise be replayed at the correct address
+    c.Examine();
+    outPos = gSCLPort.Output.length();
+    TEST_ASSERT(c.ProcessOutput('E'));
+    TEST_ASSERT(c.ProcessOutput('\xF7'));
+    gCurTime += 250000;
+    c.ProcessTimeouts();
+    outPos++;
+    TEST_ASSERT(c.ProcessOutput('.'));
+    TEST_ASSERT(c.ProcessOutput('@'));
+    TEST_ASSERT(gSCLPort.Output.compare(outPos, std::string::npos, "L 3000\r") == 0);
+    SimulateConsole(c, outPos);
+    TEST_ASSERT(gSCLPort.Output.compare(outPos - 2, std::string::npos, "E ") == 0);
+    const char * p = "003000 000123 \r\n@";
+    DriveController(c, p);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(c.LastCommand() == 'E');
+    TEST_ASSERT(c.LastAddress() == 03000);
+    TEST_ASSERT(c.LastExamineValue() == 0123);
+
+    // Repeated failures should eventually be reported
+    c.Deposit(0456);
+    bool failed = false;
+    for (int i = 0; i < 10 && !failed; i++) {
+        failed = !c.ProcessOutput('\xF7');
+        gCurTime += 250000;
+        c.ProcessTimeouts();
+        c.ProcessOutput('.');
+        c.ProcessOutput('@');
+    }
+    TEST_ASSERT(failed);
+
+    printf("PASS\n");
+
+    return true;
+}
+
+/** Test 9 -- Baud-Scaled Timeouts */
+bool Test9(void)
+{
+    M93xxController c;
+
+    printf("TEST9 ................. ");
+    fflush(stdout);
+
+    // With no character time, the fixed timeouts apply
+    InitController(c);
+    TEST_ASSERT(c.IdleTimeoutUS() == 200000);
+    TEST_ASSERT(c.PromptTimeoutUS() == 5000000);
+
+    // At 110 baud, the timeouts should span several characters
+    c.SetCharTime(100000);
+    TEST_ASSERT(c.IdleTimeoutUS() == 400000);
+    TEST_ASSERT(c.PromptTimeoutUS() == 6400000);
+
+    // At 9600 baud, the idle timeout should be a few character times, and
+    // the prompt timeout should be subject to its minimum
+    c.SetCharTime(1042);
+    TEST_ASSERT(c.IdleTimeoutUS() == 4168);
+    TEST_ASSERT(c.PromptTimeoutUS() == 1000000);
+
+    // Gaps between characters output by the console should extend the timeouts
+    gSCLPort.Output.clear();
+    c.SetAddress(01000);
+    const char * p = "L 1000\r\n@";
+    c.ProcessOutput(*p++);
+    gCurTime += 1042;
+    c.ProcessOutput(*p++);
+    gCurTime += 5000;
+    c.ProcessOutput(*p++);
+    TEST_ASSERT(c.IdleTimeoutUS() == 20000);
+
+    // ... but a single long stall should be limited
+    gCurTime += 1000000;
+    c.ProcessOutput(*p++);
+    TEST_ASSERT(c.IdleTimeoutUS() == 4 * 16 * 1042);
+    while (*p) {
+        c.ProcessOutput(*p++);
+    }
+    TEST_ASSERT(c.IsReadyForCommand());
+
+    // The gaps observed should carry over to the next session at the same
+    // character time, but not to one at a different character time
+    M93xxController c2;
+    c2.SetCharTime(1042);
+    TEST_ASSERT(c2.IdleTimeoutUS() == 4 * 16 * 1042);
+    c2.SetCharTime(260);
+    TEST_ASSERT(c2.IdleTimeoutUS() == 1040);
+
+    // Timeouts should be armed using the scaled values
+    InitController(c2);
+    gSCLPort.Output.clear();
+    c2.SetAddress(01000);
+    c2.ProcessOutput('L');
+    gCurTime += 1000000 - 1;
+    TEST_ASSERT(!c2.ProcessTimeouts());
+    gCurTime += 1;
+    TEST_ASSERT(c2.ProcessTimeouts());
+
+    printf("PASS\n");
+
+    return true;
+}
+
+/** Test 10 -- Bus Error Detection */
+bool Test10(void)
+{
+    static const char * ConsoleOutput =
+        "000000 000000 000000 000000\r\n"
+        "@L 77776\r\n"
+        "@E 077776 001234 \r\n"
+        "@L 157776\r\n"
+        "@E \r\n000000 157776 000500 165212\r\n"
+        "@L 57776\r\n"
+        "@D 5\r\n\r\n000000 057776 000500 165212\r\n"
+        "@L 1000\r\n"
+        "@D 5\r\n"
+        "@";
+
+    M93xxController c;
+    const char *p = ConsoleOutput;
+
+    printf("TEST10 ................ ");
+    fflush(stdout);
+
+    InitController(c);
+    TEST_ASSERT(c.IsReadyForCommand());
+
+    // The register dump output when the console is first entered should
+    // not be mistaken for a fault
+    DriveController(c, p);
+    TEST_ASSERT(!c.LastCommandFaulted());
+
+    // Examining existing memory should succeed
+    DriveController(c, p);
+    DriveController(c, p);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(!c.LastCommandFaulted());
+    TEST_ASSERT(c.LastCommand() == 'E');
+    TEST_ASSERT(c.LastAddress() == 077776);
+    TEST_ASSERT(c.LastExamineValue() == 01234);
+
+    // Examining non-existent memory should be reported as a fault, leaving
+    // the console's address unknown
+    DriveController(c, p);
+    DriveController(c, p);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(c.LastCommandFaulted());
+    TEST_ASSERT(c.LastAddress() == M93xxController::kUnknownAddress);
+    TEST_ASSERT(c.NextExamineAddress() == M93xxController::kUnknownAddress);
+
+    // As should depositing into non-existent memory
+    DriveController(c, p);
+    TEST_ASSERT(!c.LastCommandFaulted());
+    TEST_ASSERT(c.LastAddress() == 057776);
+    DriveController(c, p);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(c.LastCommandFaulted());
+    TEST_ASSERT(c.NextDepositAddress() == M93xxController::kUnknownAddress);
+
+    // The fault should be cleared by the next command
+    DriveController(c, p);
+    DriveController(c, p);
+    TEST_ASSERT(c.IsReadyForCommand());
+    TEST_ASSERT(!c.LastCommandFaulted());
+    TEST_ASSERT(c.LastCommand() == 'D');
+    TEST_ASSERT(c.LastAddress() == 01000);
+
+    printf("PASS\n");
+
+    return true;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -684,6 +1601,13 @@ main(int argc, char *argv[])
     if (!Test1()) failures++;
     if (!Test2()) failures++;
     if (!Test3()) failures++;
+    if (!Test4()) failures++;
+    if (!Test5()) failures++;
+    if (!Test6()) failures++;
+    if (!Test7()) failures++;
+    if (!Test8()) failures++;
+    if (!Test9()) failures++;
+    if (!Test10()) failures++;
 
     printf("%d failure%s\n", failures, failures != 1 ? "s" : "");
 
@@ -18,6 +18,7 @@
 #define M93XX_CONTROLLER_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 /** Provides an API for interacting with a PDP-11 M9301/M9312 console emulator
  */
@@ -30,6 +31,13 @@ public:
     bool ProcessOutput(char ch);
     bool ProcessTimeouts(void);
     bool IsReadyForCommand(void) const;
+    bool CanQueueCommand(void) const;
+    void SetPipelineWindow(size_t windowChars);
+    void SetCharTime(uint32_t charTimeUS);
+    uint32_t IdleTimeoutUS(void) const;
+    uint32_t PromptTimeoutUS(void) const;
+    bool IsPipelined(void) const;
+    size_t UnconfirmedCommandCount(void) const;
     void SetAddress(uint16_t addr);
     void Examine(void);
     void Deposit(uint16_t val);
@@ -39,11 +47,30 @@ public:
     char LastCommand(void) const;
     uint16_t LastAddress(void) const;
     uint16_t LastExamineValue(void) const;
+    bool LastCommandFaulted(void) const;
+    bool GetExamineResult(uint16_t& addr, uint16_t& val);
     uint16_t NextDepositAddress(void) const;
     uint16_t NextExamineAddress(void) const;
+    uint32_t ErrorCount(void) const;
+    uint32_t RecoveryCount(void) const;
+
+    static size_t SetAddressCmdLen(uint16_t addr);
+    static size_t DepositCmdLen(uint16_t val);
 
     static constexpr uint16_t kUnknownAddress = UINT16_MAX;
 
+    // Number of characters, beyond the echoed command, that the console
+    // outputs in response to a command (a LF and the next prompt)
+    static constexpr size_t kResponseOverhead = 2;
+
+    // Number of characters output by the console in response to an examine
+    // command, following the echoed "E " and ahead of the response overhead:
+    // a 6 digit address, a space, a 6 digit value, a space and a CR.
+    static constexpr size_t kExamineResponseLen = 6 + 1 + 6 + 1 + 1;
+
+    // Number of characters output by the console for each examine command
+    static constexpr size_t kExamineOutputLen = 2 + kExamineResponseLen + kResponseOverhead;
+
 private:
     enum {
         kStart,
@@ -58,10 +85,84 @@ private:
     char mLastCmd;
     uint16_t mLastAddr;
     uint16_t mLastVal;
+    bool mLastCmdFaulted;
     int mDigitsParsed;
     uint64_t mPromptTimeoutTime;
     uint64_t mIdleTimeoutTime;
 
+    // Time to transmit one character on the serial line (0 if unknown), and
+    // the longest gap observed between characters output by the console
+    // while responding to a command.
+    uint32_t mCharTimeUS;
+    uint32_t mMaxGapUS;
+    uint64_t mLastOutputTime;
+
+    // Longest gap observed during the previous session, and the character
+    // time at which it was observed.  Used as the starting point for the
+    // next session at the same character time.
+    static uint32_t sObservedGapUS;
+    static uint32_t sObservedCharTimeUS;
+
+    // Commands queued for pipelined sending.  Each command remains in the
+    // pipeline until the console has echoed it and issued a new prompt.
+    struct PipelineCmd
+    {
+        char Text[10];
+        uint8_t Len;
+        char Cmd;
+        uint16_t Addr;
+    };
+    static constexpr size_t kPipelineDepth = 4;
+    PipelineCmd mPipe[kPipelineDepth];
+    size_t mPipeHead;
+    size_t mPipeCount;
+    size_t mTxCmd, mTxPos;
+    size_t mEchoCmd, mEchoPos;
+    size_t mResponsePos;
+    size_t mOutstanding;
+    size_t mPipelineWindow;
+    enum {
+        kPipelineNormal,
+        kPipelineResync,
+        kPipelineSync,
+        kPipelineReplay
+    } mPipelineState;
+    bool mReplayAddrSent;
+
+    // Command sent outside of the pipeline that is awaiting confirmation,
+    // which is replayed if the console's output is garbled.
+    PipelineCmd mLockStepCmd;
+    bool mLockStepPending;
+
+    // Results (address and value) of confirmed examine commands that have
+    // yet to be collected via GetExamineResult(), in the order the commands
+    // were issued.  A faulted examine yields an unknown address.
+    struct ExamineResult
+    {
+        uint16_t Addr;
+        uint16_t Val;
+    };
+    static constexpr size_t kMaxExamineResults = kPipelineDepth + 1;
+    ExamineResult mExamineResults[kMaxExamineResults];
+    size_t mExamineResultHead;
+    size_t mExamineResultCount;
+
+    // Error recovery state and statistics
+    bool mResyncWithSync;
+    uint32_t mRecoveryAttempts;
+    uint32_t mErrorCount;
+    uint32_t mRecoveryCount;
+
+    void InitCommand(PipelineCmd& entry, char cmd, uint16_t val, uint16_t addr);
+    void SendCommand(char cmd, uint16_t val, uint16_t addr);
+    void QueueCommand(char cmd, uint16_t val, uint16_t addr);
+    void PumpPipeline(void);
+    void RecordExamineResult(void);
+    bool MatchPipelineOutput(char ch);
+    void BeginResync(void);
+    bool BeginRecovery(void);
+    PipelineCmd& PipeEntry(size_t index);
+    const PipelineCmd& PipeEntry(size_t index) const;
     bool IsValidOutputChar(char ch);
     void ArmPromptTimeout(void);
     bool PromptTimeoutExpired(void);
@@ -69,14 +170,34 @@ private:
     void ArmIdleTimeout(void);
     bool IdleTimeoutExpired(void);
     void CancelIdleTimeout(void);
+    void RecordOutputGap(void);
+    uint32_t CharIntervalUS(void) const;
 
+    // Timeouts used when the character time is unknown
     static constexpr uint32_t kPromptTimeoutUS = 5 * 1000 * 1000;
     static constexpr uint32_t kIdleTimeoutUS = 200 * 1000;
+
+    // When the character time is known, the idle and prompt timeouts are
+    // the given number of character intervals (the character time, or the
+    // longest gap observed between characters output by the console, if
+    // greater), subject to a minimum.  Observed gaps are limited to a
+    // multiple of the character time, to avoid a single stall inflating the
+    // timeouts for the rest of the session.
+    static constexpr uint32_t kIdleTimeoutChars = 4;
+    static constexpr uint32_t kMinIdleTimeoutUS = 1000;
+    static constexpr uint32_t kPromptTimeoutChars = 64;
+    static constexpr uint32_t kMinPromptTimeoutUS = 1000 * 1000;
+    static constexpr uint32_t kMaxGapChars = 16;
     static constexpr char kSyncChar = '.';
+
+    // Maximum number of consecutive attempts to recover from garbled console
+    // output before giving up
+    static constexpr uint32_t kMaxRecoveryAttempts = 3;
 };
 
 inline
 M93xxController::M93xxController()
+: mCharTimeUS(0), mMaxGapUS(0), mPipelineWindow(0)
 {
     Reset();
 }
@@ -99,28 +220,96 @@ uint16_t M93xxController::LastExamineValue(void) const
     return mLastVal;
 }
 
+inline
+bool M93xxController::LastCommandFaulted(void) const
+{
+    return mLastCmdFaulted;
+}
+
+inline
+uint32_t M93xxController::ErrorCount(void) const
+{
+    return mErrorCount;
+}
+
+inline
+uint32_t M93xxController::RecoveryCount(void) const
+{
+    return mRecoveryCount;
+}
+
 inline
 uint16_t M93xxController::NextDepositAddress(void) const
 {
+    // If commands are queued in the pipeline, the next deposit address
+    // follows from the last queued command.
+    if (mPipeCount > 0) {
+        const PipelineCmd& cmd = PipeEntry(mPipeCount - 1);
+        return (cmd.Cmd == 'D') ? cmd.Addr + 2 : cmd.Addr;
+    }
     return (mLastAddr != kUnknownAddress && mLastCmd == 'D') ? mLastAddr + 2 : mLastAddr;
 }
 
 inline
 uint16_t M93xxController::NextExamineAddress(void) const
 {
+    // If commands are queued in the pipeline, the next examine address
+    // follows from the last queued command.
+    if (mPipeCount > 0) {
+        const PipelineCmd& cmd = PipeEntry(mPipeCount - 1);
+        return (cmd.Cmd == 'E') ? cmd.Addr + 2 : cmd.Addr;
+    }
     return (mLastAddr != kUnknownAddress && mLastCmd == 'E') ? mLastAddr + 2 : mLastAddr;
 }
 
 inline
 bool M93xxController::IsReadyForCommand(void) const
 {
-    return mState == kReadyForCommand;
+    return mState == kReadyForCommand && mPipeCount == 0 && mPipelineState == kPipelineNormal;
+}
+
+inline
+bool M93xxController::IsPipelined(void) const
+{
+    return mPipelineWindow > 0;
+}
+
+inline
+size_t M93xxController::UnconfirmedCommandCount(void) const
+{
+    // Commands still in the pipeline, plus any command the console is
+    // currently processing.
+    return mPipeCount + ((mState != kReadyForCommand) ? 1 : 0);
+}
+
+inline
+void M93xxController::SetPipelineWindow(size_t windowChars)
+{
+    mPipelineWindow = windowChars;
+}
+
+inline
+M93xxController::PipelineCmd& M93xxController::PipeEntry(size_t index)
+{
+    return mPipe[(mPipeHead + index) % kPipelineDepth];
+}
+
+inline
+const M93xxController::PipelineCmd& M93xxController::PipeEntry(size_t index) const
+{
+    return mPipe[(mPipeHead + index) % kPipelineDepth];
+}
+
+inline
+uint32_t M93xxController::CharIntervalUS(void) const
+{
+    return (mMaxGapUS > mCharTimeUS) ? mMaxGapUS : mCharTimeUS;
 }
 
 inline
 void M93xxController::ArmPromptTimeout(void)
 {
-    mPromptTimeoutTime = time_us_64() + kPromptTimeoutUS;
+    mPromptTimeoutTime = time_us_64() + PromptTimeoutUS();
 }
 
 inline
@@ -142,7 +331,7 @@ void M93xxController::CancelPromptTimeout(void)
 inline
 void M93xxController::ArmIdleTimeout(void)
 {
-    mIdleTimeoutTime = time_us_64() + kIdleTimeoutUS;
+    mIdleTimeoutTime = time_us_64() + IdleTimeoutUS();
 }
 
 inline
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConsoleAdapter.h"
+#include "Settings.h"
+#include "MemoryClear.h"
+
+/** Memory clear routine code
+ *
+ * The routine is position independent and is followed in memory by a table
+ * of ranges to be cleared, each consisting of a start address and a word
+ * count, and terminated by a zero count.  Once all ranges are cleared, the
+ * routine jumps to the console emulator, which issues a new prompt.
+ */
+static const uint16_t sMemoryClearCode[] = {
+    0010700,            // 000          MOV     PC,R0
+    0062700, 0000026,   // 002          ADD     #TBL-.,R0       ; R0 = range table
+    0012001,            // 006  NEXT:   MOV     (R0)+,R1        ; range start address
+    0012002,            // 010          MOV     (R0)+,R2        ; range word count
+    0001404,            // 012          BEQ     DONE
+    0005021,            // 014  CLEAR:  CLR     (R1)+
+    0005302,            // 016          DEC     R2
+    0001375,            // 020          BNE     CLEAR
+    0000771,            // 022          BR      NEXT
+    0000137,            // 024  DONE:   JMP     @#CONSOLE       ; re-enter console emulator
+    0000000             // 026          (console entry address, from settings)
+                        // 030  TBL:    range table
+};
+constexpr static size_t sMemoryClearCodeLen = sizeof(sMemoryClearCode) / sizeof(sMemoryClearCode[0]);
+constexpr static size_t kConsoleEntryWord = 026 / 2;
+
+bool MemoryClearDataSource::GetWord(uint16_t& data, uint16_t& addr)
+{
+    if (mCurWord >= WordCount()) {
+        return false;
+    }
+
+    addr = mLoadAddr + ((uint16_t)mCurWord * 2);
+
+    if (mCurWord == kConsoleEntryWord) {
+        data = Settings::ConsoleEntryAddr;
+    }
+    else if (mCurWord < sMemoryClearCodeLen) {
+        data = sMemoryClearCode[mCurWord];
+    }
+    else {
+        size_t tableIndex = mCurWord - sMemoryClearCodeLen;
+        size_t rangeIndex = tableIndex / 2;
+        if (rangeIndex < mRangeCount) {
+            data = (tableIndex % 2 == 0) ? mRanges[rangeIndex].Addr : mRanges[rangeIndex].WordCount;
+        }
+        else {
+            data = 0;
+        }
+    }
+
+    return true;
+}
+
+void MemoryClearDataSource::Advance(void)
+{
+    if (mCurWord < WordCount()) {
+        mCurWord++;
+    }
+}
+
+bool MemoryClearDataSource::AtEnd(void)
+{
+    return mCurWord >= WordCount();
+}
+
+uint16_t MemoryClearDataSource::GetStartAddress(void)
+{
+    return mLoadAddr;
+}
+
+void MemoryClearDataSource::Rewind(void)
+{
+    mCurWord = 0;
+}
+
+bool MemoryClearDataSource::Plan(LoadDataSource& image)
+{
+    uint16_t data, addr;
+    uint16_t runAddr = 0, runCount = 0;
+    uint16_t nextAddr = NO_ADDR;
+
+    mRangeCount = 0;
+    mLoadAddr = NO_ADDR;
+    mCurWord = 0;
+
+    // Find the longest runs of zero words at consecutive addresses within
+    // the image.
+    image.Rewind();
+    while (!image.AtEnd() && image.GetWord(data, addr)) {
+        if (data == 0 && runCount > 0 && addr == nextAddr && runCount < UINT16_MAX) {
+            runCount++;
+        }
+        else {
+            AddRun(runAddr, runCount);
+            runAddr = addr;
+            runCount = (data == 0) ? 1 : 0;
+        }
+        nextAddr = addr + 2;
+        image.Advance();
+    }
+    AddRun(runAddr, runCount);
+
+    // If the image also loads a non-zero value into a range (as can happen
+    // when the image contains overlapping blocks), the range can't be
+    // skipped safely, so drop it.
+    image.Rewind();
+    while (mRangeCount > 0 && !image.AtEnd() && image.GetWord(data, addr)) {
+        if (data != 0) {
+            for (size_t i = 0; i < mRangeCount; ) {
+                if (addr >= mRanges[i].Addr && addr < (uint32_t)mRanges[i].Addr + mRanges[i].WordCount * 2U) {
+                    RemoveRange(i);
+                }
+                else {
+                    i++;
+                }
+            }
+        }
+        image.Advance();
+    }
+    image.Rewind();
+
+    if (mRangeCount == 0) {
+        return false;
+    }
+
+    // Place the routine at the end of the longest range, and exclude the
+    // words it occupies from that range.  The corresponding zero words in the
+    // image are deposited normally after the routine has run.
+    size_t longest = 0;
+    for (size_t i = 1; i < mRangeCount; i++) {
+        if (mRanges[i].WordCount > mRanges[longest].WordCount) {
+            longest = i;
+        }
+    }
+    if (mRanges[longest].WordCount < WordCount() + ZERO_RUN_MIN_WORDS) {
+        mRangeCount = 0;
+        return false;
+    }
+    mRanges[longest].WordCount = (uint16_t)(mRanges[longest].WordCount - WordCount());
+    mLoadAddr = (uint16_t)(mRanges[longest].Addr + mRanges[longest].WordCount * 2U);
+
+    // Drop any other range that overlaps the routine (again, only possible
+    // with overlapping blocks), so that the routine never clears itself.
+    uint32_t routineEnd = (uint32_t)mLoadAddr + WordCount() * 2U;
+    for (size_t i = 0; i < mRangeCount; ) {
+        if (i != longest && mRanges[i].Addr < routineEnd &&
+            (uint32_t)mRanges[i].Addr + mRanges[i].WordCount * 2U > mLoadAddr) {
+            RemoveRange(i);
+            if (longest > i) {
+                longest--;
+            }
+        }
+        else {
+            i++;
+        }
+    }
+
+    // Sort the ranges by address.
+    for (size_t i = 1; i < mRangeCount; i++) {
+        Range range = mRanges[i];
+        size_t j = i;
+        for (; j > 0 && mRanges[j - 1].Addr > range.Addr; j--) {
+            mRanges[j] = mRanges[j - 1];
+        }
+        mRanges[j] = range;
+    }
+
+    return true;
+}
+
+bool MemoryClearDataSource::IsCleared(uint16_t addr) const
+{
+    for (size_t i = 0; i < mRangeCount; i++) {
+        if (addr >= mRanges[i].Addr && addr < (uint32_t)mRanges[i].Addr + mRanges[i].WordCount * 2U) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MemoryClearDataSource::IsClearedInterior(uint16_t addr) const
+{
+    // Determine if the address is cleared by the routine, but is neither the
+    // first nor the last word of its range.
+    for (size_t i = 0; i < mRangeCount; i++) {
+        if (addr > mRanges[i].Addr && addr + 2U < (uint32_t)mRanges[i].Addr + mRanges[i].WordCount * 2U) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t MemoryClearDataSource::ClearedWordCount(void) const
+{
+    uint32_t count = 0;
+    for (size_t i = 0; i < mRangeCount; i++) {
+        count += mRanges[i].WordCount;
+    }
+    return count;
+}
+
+size_t MemoryClearDataSource::WordCount(void) const
+{
+    // Routine code, followed by the range table and its terminating entry
+    return sMemoryClearCodeLen + (mRangeCount + 1) * 2;
+}
+
+void MemoryClearDataSource::AddRun(uint16_t addr, uint16_t wordCount)
+{
+    if (wordCount < ZERO_RUN_MIN_WORDS) {
+        return;
+    }
+
+    // Add the run as a new range if there is room; otherwise replace the
+    // shortest range if the run is longer.
+    if (mRangeCount < kMaxRanges) {
+        mRanges[mRangeCount++] = { addr, wordCount };
+        return;
+    }
+    size_t shortest = 0;
+    for (size_t i = 1; i < mRangeCount; i++) {
+        if (mRanges[i].WordCount < mRanges[shortest].WordCount) {
+            shortest = i;
+        }
+    }
+    if (wordCount > mRanges[shortest].WordCount) {
+        mRanges[shortest] = { addr, wordCount };
+    }
+}
+
+void MemoryClearDataSource::RemoveRange(size_t index)
+{
+    mRangeCount--;
+    for (size_t i = index; i < mRangeCount; i++) {
+        mRanges[i] = mRanges[i + 1];
+    }
+}
+
+bool ZeroSkipDataSource::GetWord(uint16_t& data, uint16_t& addr)
+{
+    SkipClearedWords();
+    return !mImage.AtEnd() && mImage.GetWord(data, addr);
+}
+
+void ZeroSkipDataSource::Advance(void)
+{
+    mImage.Advance();
+}
+
+bool ZeroSkipDataSource::GetRun(uint16_t& addr, const uint8_t *& data, size_t& len)
+{
+    SkipClearedWords();
+    if (mImage.AtEnd() || !mImage.GetRun(addr, data, len)) {
+        return false;
+    }
+
+    // End the run at the first word that is cleared by the memory clear
+    // routine.
+    for (size_t i = 0; i < len; i += 2) {
+        if (data[i] == 0 && (i + 1 >= len || data[i + 1] == 0) && mClearSrc.IsCleared((uint16_t)(addr + i))) {
+            len = i;
+            break;
+        }
+    }
+    return true;
+}
+
+void ZeroSkipDataSource::AdvanceRun(size_t len)
+{
+    mImage.AdvanceRun(len);
+}
+
+bool ZeroSkipDataSource::AtEnd(void)
+{
+    SkipClearedWords();
+    return mImage.AtEnd();
+}
+
+uint16_t ZeroSkipDataSource::GetStartAddress(void)
+{
+    return mImage.GetStartAddress();
+}
+
+void ZeroSkipDataSource::Rewind(void)
+{
+    mImage.Rewind();
+}
+
+void ZeroSkipDataSource::SkipClearedWords(void)
+{
+    uint16_t data, addr;
+
+    while (!mImage.AtEnd() && mImage.GetWord(data, addr) && data == 0 && mClearSrc.IsCleared(addr)) {
+        mImage.Advance();
+    }
+}
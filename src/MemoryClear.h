@@ -0,0 +1,107 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEMORY_CLEAR_H
+#define MEMORY_CLEAR_H
+
+/** Data source for a small PDP-11 routine that clears a set of memory ranges
+ *  and then returns to the M9301/M9312 console emulator
+ *
+ * The routine is planned from the zero runs found in a memory image, and is
+ * placed at the end of the longest such run.
+ */
+class MemoryClearDataSource final : public LoadDataSource
+{
+public:
+    MemoryClearDataSource(void);
+    ~MemoryClearDataSource() = default;
+    MemoryClearDataSource(const MemoryClearDataSource&) = delete;
+
+    virtual bool GetWord(uint16_t& data, uint16_t& addr);
+    virtual void Advance(void);
+    virtual bool AtEnd(void);
+    virtual uint16_t GetStartAddress(void);
+    virtual void Rewind(void);
+
+    bool Plan(LoadDataSource& image);
+    bool IsCleared(uint16_t addr) const;
+    bool IsClearedInterior(uint16_t addr) const;
+    size_t RangeCount(void) const;
+    uint32_t ClearedWordCount(void) const;
+
+    // Number of characters output by the console when the routine is started
+    // and the console emulator is re-entered (the echoed start command, the
+    // register display and the new prompt)
+    static constexpr uint32_t kStartOverheadChars = 40;
+
+private:
+    struct Range
+    {
+        uint16_t Addr;
+        uint16_t WordCount;
+    };
+    static constexpr size_t kMaxRanges = ZERO_RUN_MAX_RANGES;
+    Range mRanges[kMaxRanges];
+    size_t mRangeCount;
+    uint16_t mLoadAddr;
+    size_t mCurWord;
+
+    size_t WordCount(void) const;
+    void AddRun(uint16_t addr, uint16_t wordCount);
+    void RemoveRange(size_t index);
+};
+
+/** Wraps a memory image data source, skipping the words that are cleared
+ *  by a memory clear routine
+ */
+class ZeroSkipDataSource final : public LoadDataSource
+{
+public:
+    ZeroSkipDataSource(LoadDataSource& image, const MemoryClearDataSource& clearSrc);
+    ~ZeroSkipDataSource() = default;
+    ZeroSkipDataSource(const ZeroSkipDataSource&) = delete;
+
+    virtual bool GetWord(uint16_t& data, uint16_t& addr);
+    virtual void Advance(void);
+    virtual bool AtEnd(void);
+    virtual uint16_t GetStartAddress(void);
+    virtual void Rewind(void);
+    virtual bool GetRun(uint16_t& addr, const uint8_t *& data, size_t& len);
+    virtual void AdvanceRun(size_t len);
+
+private:
+    LoadDataSource& mImage;
+    const MemoryClearDataSource& mClearSrc;
+
+    void SkipClearedWords(void);
+};
+
+inline MemoryClearDataSource::MemoryClearDataSource(void)
+: mRangeCount(0), mLoadAddr(NO_ADDR), mCurWord(0)
+{
+}
+
+inline size_t MemoryClearDataSource::RangeCount(void) const
+{
+    return mRangeCount;
+}
+
+inline ZeroSkipDataSource::ZeroSkipDataSource(LoadDataSource& image, const MemoryClearDataSource& clearSrc)
+: mImage(image), mClearSrc(clearSrc)
+{
+}
+
+#endif // MEMORY_CLEAR_H
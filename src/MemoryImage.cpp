@@ -0,0 +1,219 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConsoleAdapter.h"
+#include "MemoryImage.h"
+
+MemoryImage::MemoryImage(void)
+{
+    Clear();
+}
+
+void MemoryImage::Clear(void)
+{
+    for (uint32_t i = 0; i < kPageCount; i++) {
+        mPageMap[i] = kNoPage;
+    }
+    mPagesUsed = 0;
+    mWordCount = 0;
+    mStartAddr = NO_ADDR;
+    mCurAddr = kEndAddr;
+}
+
+bool MemoryImage::Materialize(LoadDataSource& dataSrc)
+{
+    Clear();
+
+    if (!Add(dataSrc)) {
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool MemoryImage::Add(LoadDataSource& dataSrc)
+{
+    uint16_t data, addr;
+    const uint8_t * runData;
+    size_t runLen;
+    bool success = true;
+
+    // Copy every run of words from the data source into the image, replacing
+    // any words already present at the same addresses.  Fail if the image
+    // runs out of pages, or if the data source is unable to supply all of its
+    // words up front.
+    dataSrc.Rewind();
+    while (success && !dataSrc.AtEnd() && dataSrc.GetRun(addr, runData, runLen)) {
+        for (size_t i = 0; success && i < runLen; i += 2) {
+            data = runData[i];
+            if (i + 1 < runLen) {
+                data |= (uint16_t)(runData[i + 1] << 8);
+            }
+            success = Set((uint16_t)(addr + i), data);
+        }
+        dataSrc.AdvanceRun(runLen);
+    }
+    success = success && dataSrc.AtEnd();
+    dataSrc.Rewind();
+
+    if (!success) {
+        return false;
+    }
+
+    // The start address of the image is that of the last data source to
+    // specify one.
+    if (dataSrc.GetStartAddress() != NO_ADDR) {
+        mStartAddr = dataSrc.GetStartAddress();
+    }
+    Rewind();
+    return true;
+}
+
+bool MemoryImage::Set(uint16_t addr, uint16_t data)
+{
+    uint32_t pageNum = addr / kPageBytes;
+    uint32_t wordIndex = (addr % kPageBytes) / 2;
+
+    // Allocate a page for the address if necessary.
+    if (mPageMap[pageNum] == kNoPage) {
+        if (mPagesUsed == kMaxPages) {
+            return false;
+        }
+        mPageMap[pageNum] = (uint16_t)mPagesUsed;
+        mPages[mPagesUsed++].Present = 0;
+    }
+
+    Page& page = mPages[mPageMap[pageNum]];
+    uint64_t bit = 1ULL << wordIndex;
+    if ((page.Present & bit) == 0) {
+        page.Present |= bit;
+        mWordCount++;
+    }
+    page.Data[wordIndex] = data;
+    return true;
+}
+
+bool MemoryImage::Get(uint16_t addr, uint16_t& data) const
+{
+    uint32_t pageNum = addr / kPageBytes;
+    uint32_t wordIndex = (addr % kPageBytes) / 2;
+
+    if (!IsPresent(addr)) {
+        return false;
+    }
+    data = mPages[mPageMap[pageNum]].Data[wordIndex];
+    return true;
+}
+
+bool MemoryImage::IsPresent(uint16_t addr) const
+{
+    uint32_t pageNum = addr / kPageBytes;
+    uint32_t wordIndex = (addr % kPageBytes) / 2;
+
+    return mPageMap[pageNum] != kNoPage &&
+           (mPages[mPageMap[pageNum]].Present & (1ULL << wordIndex)) != 0;
+}
+
+bool MemoryImage::NextRun(uint32_t fromAddr, uint16_t& runAddr, uint32_t& runWords) const
+{
+    uint32_t addr = FindPresent(fromAddr);
+    if (addr >= kEndAddr) {
+        return false;
+    }
+
+    // Extend the run across consecutive present words, including across
+    // page boundaries.
+    runAddr = (uint16_t)addr;
+    runWords = 0;
+    while (addr < kEndAddr && IsPresent((uint16_t)addr)) {
+        runWords++;
+        addr += 2;
+    }
+    return true;
+}
+
+bool MemoryImage::GetWord(uint16_t& data, uint16_t& addr)
+{
+    if (mCurAddr >= kEndAddr) {
+        return false;
+    }
+    addr = (uint16_t)mCurAddr;
+    return Get(addr, data);
+}
+
+void MemoryImage::Advance(void)
+{
+    if (mCurAddr < kEndAddr) {
+        mCurAddr = FindPresent(mCurAddr + 2);
+    }
+}
+
+bool MemoryImage::GetRun(uint16_t& addr, const uint8_t *& data, size_t& len)
+{
+    if (mCurAddr >= kEndAddr) {
+        return false;
+    }
+
+    // The run consists of the consecutive present words that follow within
+    // the current page.  Pages hold words in the native byte order of the
+    // RP2040, which is the same as that of the PDP-11.
+    const Page& page = mPages[mPageMap[mCurAddr / kPageBytes]];
+    uint32_t wordIndex = (mCurAddr % kPageBytes) / 2;
+    uint64_t absent = ~(page.Present >> wordIndex);
+    uint32_t runWords = (absent != 0) ? (uint32_t)__builtin_ctzll(absent) : kPageWords - wordIndex;
+    addr = (uint16_t)mCurAddr;
+    data = (const uint8_t *)&page.Data[wordIndex];
+    len = MIN(runWords, kPageWords - wordIndex) * 2;
+    return true;
+}
+
+void MemoryImage::AdvanceRun(size_t len)
+{
+    if (mCurAddr < kEndAddr) {
+        mCurAddr = FindPresent(mCurAddr + (uint32_t)((len + 1) & ~(size_t)1));
+    }
+}
+
+bool MemoryImage::AtEnd(void)
+{
+    return mCurAddr >= kEndAddr;
+}
+
+void MemoryImage::Rewind(void)
+{
+    mCurAddr = FindPresent(0);
+}
+
+uint32_t MemoryImage::FindPresent(uint32_t fromAddr) const
+{
+    fromAddr &= ~1U;
+
+    // Scan the page map for the first present word at or after the given
+    // address, skipping unallocated pages entirely.
+    while (fromAddr < kEndAddr) {
+        uint32_t pageNum = fromAddr / kPageBytes;
+        if (mPageMap[pageNum] != kNoPage) {
+            uint32_t wordIndex = (fromAddr % kPageBytes) / 2;
+            uint64_t present = mPages[mPageMap[pageNum]].Present >> wordIndex;
+            if (present != 0) {
+                return fromAddr + (uint32_t)__builtin_ctzll(present) * 2;
+            }
+        }
+        fromAddr = (pageNum + 1) * kPageBytes;
+    }
+    return kEndAddr;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEMORY_IMAGE_H
+#define MEMORY_IMAGE_H
+
+/** A sparse image of the PDP-11's 64 KB address space
+ *
+ * Words are stored in fixed-size pages that are allocated from a pool as
+ * needed, with a presence bit for each word.  Any data source can be
+ * materialized into an image, after which the image presents the loaded
+ * words as a data source in address order, with overlapping writes resolved
+ * in favor of the last word written.
+ */
+class MemoryImage final : public LoadDataSource
+{
+public:
+    MemoryImage(void);
+    ~MemoryImage() = default;
+    MemoryImage(const MemoryImage&) = delete;
+
+    virtual bool GetWord(uint16_t& data, uint16_t& addr);
+    virtual void Advance(void);
+    virtual bool AtEnd(void);
+    virtual uint16_t GetStartAddress(void);
+    virtual void Rewind(void);
+    virtual bool GetRun(uint16_t& addr, const uint8_t *& data, size_t& len);
+    virtual void AdvanceRun(size_t len);
+
+    void Clear(void);
+    bool Materialize(LoadDataSource& dataSrc);
+    bool Add(LoadDataSource& dataSrc);
+    bool Set(uint16_t addr, uint16_t data);
+    bool Get(uint16_t addr, uint16_t& data) const;
+    bool IsPresent(uint16_t addr) const;
+    bool NextRun(uint32_t fromAddr, uint16_t& runAddr, uint32_t& runWords) const;
+    void SetStartAddress(uint16_t startAddr);
+    uint32_t WordCount(void) const;
+
+    static constexpr uint32_t kEndAddr = 0x10000;
+
+private:
+    static constexpr uint32_t kPageWords = 64;
+    static constexpr uint32_t kPageBytes = kPageWords * 2;
+    static constexpr uint32_t kPageCount = kEndAddr / kPageBytes;
+    static constexpr size_t kMaxPages = MEMORY_IMAGE_MAX_PAGES;
+    static constexpr uint16_t kNoPage = UINT16_MAX;
+
+    struct Page
+    {
+        uint16_t Data[kPageWords];
+        uint64_t Present;
+    };
+
+    uint16_t mPageMap[kPageCount];
+    Page mPages[kMaxPages];
+    size_t mPagesUsed;
+    uint32_t mWordCount;
+    uint16_t mStartAddr;
+    uint32_t mCurAddr;
+
+    uint32_t FindPresent(uint32_t fromAddr) const;
+};
+
+inline uint16_t MemoryImage::GetStartAddress(void)
+{
+    return mStartAddr;
+}
+
+inline void MemoryImage::SetStartAddress(uint16_t startAddr)
+{
+    mStartAddr = startAddr;
+}
+
+inline uint32_t MemoryImage::WordCount(void) const
+{
+    return mWordCount;
+}
+
+#endif // MEMORY_IMAGE_H
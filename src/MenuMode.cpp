@@ -23,32 +23,84 @@
 #include "BootstrapLoader.h"
 #include "AbsoluteLoader.h"
 #include "LDADataSource.h"
+#include "BinaryLDATape.h"
+#include "HighSpeedLoader.h"
 #include "SimpleDataSource.h"
 #include "UploadFileMode.h"
+#include "DownloadFileMode.h"
 #include "Settings.h"
 #include "Menu.h"
+#include "InputPacer.h"
+#include "Core1.h"
+
+enum FileMenu_t {
+    kMountFileMenu,
+    kLoadFileMenu,
+    kQueueFileMenu
+};
+
+struct LoadQueueEntry
+{
+    size_t FileIndex;
+    uint32_t LoadAddr;
+
+    static constexpr size_t kUploadedFile = SIZE_MAX;
+    static constexpr uint32_t kLDAFile = UINT32_MAX;
+};
+
+static LoadQueueEntry sLoadQueue[LOAD_QUEUE_MAX_FILES];
+static size_t sLoadQueueLen = 0;
+
+// System memory size, as determined by probing or entered by the user
+static enum {
+    kMemSizeUnknown,
+    kMemSizeProbeFailed,
+    kMemSizeKnown
+} sMemSizeState = kMemSizeUnknown;
+static uint32_t sMemSizeKW = 28;
 
 static void MountPaperTape(Port& uiPort);
 static void AdapterStatus(Port& uiPort);
 static void AdapterVersion(Port& uiPort);
 static void LoadFile(Port& uiPort);
 static void LoadBootstrapLoader(Port& uiPort);
-static void LoadAbsoluteLoader(Port& uiPort);
+static bool LoadAbsoluteLoader(Port& uiPort);
+static bool LoadAbsoluteLoader(Port& uiPort, uint32_t memSizeKW);
 static void LoadLDAFile(Port& uiPort, const char * fileName, const uint8_t * fileData, size_t fileLen);
+static bool FastLoad(Port& uiPort, LoadDataSource& dataSource, size_t tapeLen, uint32_t imageEndAddr,
+                     std::function<void(void)> mountTape);
+static bool HighSpeedLoad(Port& uiPort, LoadDataSource& dataSource, const char * name);
+static uint32_t GetImageEndAddr(LoadDataSource& dataSource);
 static void LoadSimpleFile(Port& uiPort, const char * fileName, const uint8_t * fileData, size_t fileLen);
 static void UploadAndLoadFile(Port& uiPort);
 static void LoadPreviouslyUploadedFile(Port& uiPort);
-static char SelectFile(Port& uiPort, const char * title, bool includeBootstrap);
-static const Menu * BuildFileMenu(const char * title, bool includeBootstrap);
+static void LoadQueue(Port& uiPort);
+static void AddToLoadQueue(Port& uiPort);
+static void RunLoadQueue(Port& uiPort);
+static const char * GetLoadQueueEntryName(const LoadQueueEntry& entry, char * buf, size_t bufSize);
+static void DumpMemory(Port& uiPort);
+static char SelectFile(Port& uiPort, const char * title, FileMenu_t menuType);
+static const Menu * BuildFileMenu(const char * title, FileMenu_t menuType);
 static void SettingsMenu(Port& uiPort);
 static void DiagMenu(Port& uiPort);
+static void SystemMemorySizeMenu(Port& uiPort);
 static bool GetSystemMemorySize(Port& uiPort, uint32_t& memSizeKW);
+static bool InputSystemMemorySize(Port& uiPort);
+static bool GetLoadAddress(Port& uiPort, uint32_t& loadAddr);
 static bool GetInteger(Port& uiPort, uint32_t& val, unsigned base, uint32_t defaultVal = UINT32_MAX);
 static bool GetSerialConfig(Port& uiPort, const char * title, SerialConfig& serialConfig);
 static bool GetShowPTRProgress(Port& uiPort, Settings::ShowPTRProgress_t& showProgressBar);
+static bool GetInputPacing(Port& uiPort, Settings::InputPacing_t& inputPacing);
+static bool GetOverflowPolicy(Port& uiPort, const char * title, Port::OverflowPolicy_t& policy);
+static bool GetVerifyLoad(Port& uiPort, Settings::VerifyLoad_t& verifyLoad);
+static bool GetNumericSetting(Port& uiPort, const char * prompt, uint32_t minVal, uint32_t maxVal, uint32_t& val);
+static bool GetConsoleEntryAddr(Port& uiPort, uint16_t& addr);
 static const char * ToString(const SerialConfig& serialConfig, char * buf, size_t bufSize);
 static const char * ToString(bool val, char * buf, size_t bufSize);
 static const char * ToString(Settings::ShowPTRProgress_t val, char * buf, size_t bufSize);
+static const char * ToString(Settings::InputPacing_t val, char * buf, size_t bufSize);
+static const char * ToString(Port::OverflowPolicy_t val, char * buf, size_t bufSize);
+static const char * ToString(Settings::VerifyLoad_t val, char * buf, size_t bufSize);
 
 void MenuMode(Port& uiPort)
 {
@@ -56,9 +108,11 @@ void MenuMode(Port& uiPort)
         { 'm', "Mount paper tape"               },
         { 'u', "Unmount paper tape"             },
         { 's', "Adapter status"                 },
-        { 'l', "Load file using M93xx console"  },
         { 'S', "Adapter settings"               },
+        { 'l', "Load file using M93xx console"  },
+        { 'd', "Dump memory using M93xx console"},
         { 'v', "Adapter version"                },
+        { 'c', "Discard queued input"           },
         MenuItem::SEPARATOR(),
         { '\e', "Return to terminal mode"        },
         { MENU_KEY, "Send menu character"       },
@@ -92,12 +146,18 @@ void MenuMode(Port& uiPort)
     case 'l':
         LoadFile(uiPort);
         break;
+    case 'd':
+        DumpMemory(uiPort);
+        break;
     case 'S':
         SettingsMenu(uiPort);
         break;
     case 'v':
         AdapterVersion(uiPort);
         break;
+    case 'c':
+        uiPort.Printf(TITLE_PREFIX "DISCARDED %zu QUEUED INPUT CHARACTERS\r\n", InputPacer::Discard());
+        break;
     case CTRL_D:
         DiagMenu(uiPort);
         break;
@@ -124,7 +184,7 @@ void MountPaperTape(Port& uiPort)
     const uint8_t * fileData;
     size_t fileLen;
     
-    char sel = SelectFile(uiPort, "MOUNT PAPER TAPE:", false);
+    char sel = SelectFile(uiPort, "MOUNT PAPER TAPE:", kMountFileMenu);
     switch (sel) {
     case 'A':
         fileName = "Absolute Loader";
@@ -168,6 +228,7 @@ void AdapterStatus(Port& uiPort)
             : "default",
         gSCLPort.CheckConnected() ? "connected" : "disconnected"
     );
+    uiPort.Printf("    RX overruns: %" PRIu32 "\r\n", gSCLPort.RxOverrunCount());
 
     uiPort.Printf("  AUX Port: %s (%s)\r\n",
         ToString(gAuxPort.GetConfig(), buf, sizeof(buf)),
@@ -175,6 +236,31 @@ void AdapterStatus(Port& uiPort)
             ? "set via USB"
             : "default"
     );
+    uiPort.Printf("    RX overruns: %" PRIu32 "\r\n", gAuxPort.RxOverrunCount());
+    uiPort.Printf("    TX dropped: %" PRIu32 " (overflow policy: %s)\r\n",
+        gAuxPort.DroppedCount(),
+        ToString(Settings::AuxOverflowPolicy, buf, sizeof(buf)));
+
+    if (InputPacer::IsEnabled()) {
+        uiPort.Printf("  Input Pacing: %s\r\n"
+                      "    Queued characters: %zu\r\n",
+            ToString(Settings::InputPacing, buf, sizeof(buf)),
+            InputPacer::Pending());
+        if (Settings::InputPacing == Settings::InputPacing_Echo) {
+            uiPort.Printf("    Line turnaround: %" PRIu32 " ms\r\n"
+                          "    Echo timeouts: %" PRIu32 "\r\n",
+                InputPacer::LineTurnaroundUS() / 1000,
+                InputPacer::EchoTimeoutCount());
+        }
+    }
+
+    uiPort.Printf("  USB Port: %" PRIu32 " bytes sent in %" PRIu32 " flushes (%" PRIu32 " bytes/flush)\r\n",
+        HostPort::USBByteCount(),
+        HostPort::USBFlushCount(),
+        (HostPort::USBFlushCount() != 0) ? HostPort::USBByteCount() / HostPort::USBFlushCount() : 0);
+    uiPort.Printf("    TX dropped: %" PRIu32 " (overflow policy: %s)\r\n",
+        gHostPort.DroppedCount() + Core1::HostOutputDroppedCount(),
+        ToString(Settings::HostOverflowPolicy, buf, sizeof(buf)));
 
     if (PaperTapeReader::IsMounted()) {
         uiPort.Printf("  Paper Tape Reader: %s\r\n    Position: %" PRIu32 "/%" PRIu32 " (%" PRIu32 "%%)\r\n", 
@@ -186,6 +272,7 @@ void AdapterStatus(Port& uiPort)
     else {
         uiPort.Write("  Paper Tape Reader: No tape mounted\r\n");
     }
+    PaperTapeReader::PrintStats(uiPort, "    ");
 }
 
 void AdapterVersion(Port& uiPort)
@@ -227,7 +314,7 @@ void LoadFile(Port& uiPort)
     const uint8_t *fileData;
     size_t fileLen;
 
-    char sel = SelectFile(uiPort, "LOAD FILE:", true);
+    char sel = SelectFile(uiPort, "LOAD FILE:", kLoadFileMenu);
     switch (sel) {
     case 'A':
         LoadAbsoluteLoader(uiPort);
@@ -241,6 +328,15 @@ void LoadFile(Port& uiPort)
     case 'P':
         LoadPreviouslyUploadedFile(uiPort);
         break;
+    case 'Q':
+        LoadQueue(uiPort);
+        break;
+    case 'R':
+        ResumeLoadFileMode(uiPort);
+        break;
+    case 'M':
+        SystemMemorySizeMenu(uiPort);
+        break;
     case CTRL_C:
     case '\e':
         break;
@@ -274,14 +370,19 @@ void LoadBootstrapLoader(Port& uiPort)
     LoadFileMode(uiPort, dataSource, nameBuf);
 }
 
-void LoadAbsoluteLoader(Port& uiPort)
+bool LoadAbsoluteLoader(Port& uiPort)
 {
     uint32_t memSizeKW;
 
     if (!GetSystemMemorySize(uiPort, memSizeKW)) {
-        return;
+        return false;
     }
 
+    return LoadAbsoluteLoader(uiPort, memSizeKW);
+}
+
+bool LoadAbsoluteLoader(Port& uiPort, uint32_t memSizeKW)
+{
     uint16_t loadAddr = AbsoluteLoaderDataSource::MemSizeToLoadAddr(memSizeKW);
 
     AbsoluteLoaderDataSource dataSource(loadAddr);
@@ -290,7 +391,7 @@ void LoadAbsoluteLoader(Port& uiPort)
     char nameBuf[sizeof(nameFormat) + 6];
     snprintf(nameBuf, sizeof(nameBuf), nameFormat, loadAddr);
 
-    LoadFileMode(uiPort, dataSource, nameBuf);
+    return LoadFileMode(uiPort, dataSource, nameBuf);
 }
 
 void LoadLDAFile(Port& uiPort, const char * fileName, const uint8_t * fileData, size_t fileLen)
@@ -301,22 +402,154 @@ void LoadLDAFile(Port& uiPort, const char * fileName, const uint8_t * fileData,
     char nameBuf[sizeof(nameFormat) + MAX_FILE_NAME_LEN + 10];
     snprintf(nameBuf, sizeof(nameBuf), nameFormat, fileName, (unsigned)fileLen);
 
+    // If high-speed loading is enabled, load the file via the resident
+    // high-speed loader.
+    if (Settings::HighSpeedLoad && HighSpeedLoad(uiPort, dataSource, nameBuf)) {
+        return;
+    }
+
+    // If fast loading is enabled, and it would be quicker to do so, load the
+    // file using the Absolute Loader and the virtual paper tape reader.
+    if (Settings::FastLoad &&
+        FastLoad(uiPort, dataSource, fileLen, GetImageEndAddr(dataSource), [&]() {
+            PaperTapeReader::Mount(fileName, fileData, fileLen);
+        })) {
+        return;
+    }
+
     LoadFileMode(uiPort, dataSource, nameBuf);
 }
 
-void LoadSimpleFile(Port& uiPort, const char * fileName, const uint8_t * fileData, size_t fileLen)
+bool FastLoad(Port& uiPort, LoadDataSource& dataSource, size_t tapeLen, uint32_t imageEndAddr,
+              std::function<void(void)> mountTape)
 {
-    static uint32_t loadAddr;
-    static uint32_t sDefaultLoadAddr = 0;
+    uint32_t cmdCount, charCount;
+    uint32_t memSizeKW;
 
-    do {
-        uiPort.Write(INPUT_PROMPT "INPUT LOAD ADDRESS (in octal): " );
-        if (!GetInteger(uiPort, loadAddr, 8, sDefaultLoadAddr)) {
-            return;
-        }
-    } while (loadAddr > UINT16_MAX);
+    // Estimate the time needed to deposit the file's contents directly via
+    // the console, versus the time needed to deposit the Absolute Loader and
+    // then feed the file to it via the virtual paper tape reader.  Because
+    // the size of the Absolute Loader varies little with its load address,
+    // the estimate assumes the largest supported memory size.
+    AbsoluteLoaderDataSource alDataSource(AbsoluteLoaderDataSource::MemSizeToLoadAddr(28));
+    // If verifying, anything deposited via the console is also examined
+    // afterwards; data read from the tape is checked by the Absolute Loader
+    // itself.
+    uint32_t depositTimeMS = EstimateLoadTimeMS(dataSource, cmdCount, charCount);
+    uint32_t tapeTimeMS = EstimateLoadTimeMS(alDataSource, cmdCount, charCount) +
+        (uint32_t)(((uint64_t)(tapeLen + 2) * gSCLPort.GetConfig().CharTimeUS()) / 1000);
+    if (Settings::VerifyLoad != Settings::VerifyLoad_Off) {
+        depositTimeMS += EstimateVerifyTimeMS(dataSource);
+        tapeTimeMS += EstimateVerifyTimeMS(alDataSource);
+    }
 
-    sDefaultLoadAddr = loadAddr;
+    uiPort.Printf(TITLE_PREFIX "FAST LOAD: console deposit %" PRIu32 " sec, absolute loader and paper tape %" PRIu32 " sec\r\n",
+                  (depositTimeMS + 999) / 1000, (tapeTimeMS + 999) / 1000);
+
+    // If depositing via the console is quicker, let the caller do that.
+    if (tapeTimeMS >= depositTimeMS) {
+        return false;
+    }
+
+    if (!GetSystemMemorySize(uiPort, memSizeKW)) {
+        return true;
+    }
+
+    // If the file would overwrite the Absolute Loader, deposit it via the
+    // console instead.
+    if (imageEndAddr > AbsoluteLoaderDataSource::MemSizeToLoadAddr(memSizeKW)) {
+        uiPort.Write(TITLE_PREFIX "FAST LOAD NOT POSSIBLE (file overlaps Absolute Loader)\r\n");
+        return false;
+    }
+
+    // Load the Absolute Loader into memory via the console.
+    if (!LoadAbsoluteLoader(uiPort, memSizeKW)) {
+        return true;
+    }
+
+    // Mount the file on the virtual paper tape reader and start the Absolute
+    // Loader (whose start address was loaded as the last step of loading it).
+    // When the Absolute Loader reaches the end of the tape it will jump to
+    // the program's start address, if there is one, or halt.
+    mountTape();
+    uiPort.Write(TITLE_PREFIX "STARTING ABSOLUTE LOADER\r\n");
+    gSCLPort.Write("S\r");
+
+    return true;
+}
+
+bool HighSpeedLoad(Port& uiPort, LoadDataSource& dataSource, const char * name)
+{
+    uint32_t memSizeKW;
+
+    // The high-speed loader receives the image as raw 8-bit bytes, so the
+    // SCL must be configured for 8 data bits.
+    if (gSCLPort.GetConfig().DataBits != 8) {
+        uiPort.Write(TITLE_PREFIX "HIGH-SPEED LOAD NOT POSSIBLE (SCL not configured for 8 data bits)\r\n");
+        return false;
+    }
+
+    if (!GetSystemMemorySize(uiPort, memSizeKW)) {
+        return true;
+    }
+
+    // If the image would overwrite the high-speed loader, deposit it via the
+    // console instead.
+    uint16_t loadAddr = HighSpeedLoaderDataSource::MemSizeToLoadAddr(memSizeKW);
+    if (GetImageEndAddr(dataSource) > loadAddr) {
+        uiPort.Write(TITLE_PREFIX "HIGH-SPEED LOAD NOT POSSIBLE (file overlaps high-speed loader)\r\n");
+        return false;
+    }
+
+    // Load the high-speed loader into memory via the console.
+    HighSpeedLoaderDataSource loaderDataSource(loadAddr);
+
+    const char nameFormat[] = "High-Speed Loader (load address %06o)";
+    char nameBuf[sizeof(nameFormat) + 6];
+    snprintf(nameBuf, sizeof(nameBuf), nameFormat, loadAddr);
+
+    if (!LoadFileMode(uiPort, loaderDataSource, nameBuf)) {
+        return true;
+    }
+
+    // Start the high-speed loader (whose start address was loaded as the last
+    // step of loading it) and stream the file to it.  Forwarding of output
+    // from the PDP-11 is suspended beforehand, so that core1 can't consume
+    // the loader's ready signal.
+    Core1::SuspendForwarding();
+    uiPort.Write(TITLE_PREFIX "STARTING HIGH-SPEED LOADER\r\n");
+    gSCLPort.Write("S\r");
+
+    HighSpeedLoadMode(uiPort, dataSource, name);
+    Core1::ResumeForwarding();
+
+    return true;
+}
+
+uint32_t GetImageEndAddr(LoadDataSource& dataSource)
+{
+    uint32_t imageEndAddr = 0;
+    uint16_t data, addr;
+
+    // Determine the end of the memory image (the address following the
+    // highest address written by the data source).
+    dataSource.Rewind();
+    while (!dataSource.AtEnd() && dataSource.GetWord(data, addr)) {
+        imageEndAddr = MAX(imageEndAddr, (uint32_t)addr + 2);
+        dataSource.Advance();
+    }
+    dataSource.Rewind();
+
+    return imageEndAddr;
+}
+
+void LoadSimpleFile(Port& uiPort, const char * fileName, const uint8_t * fileData, size_t fileLen)
+{
+    uint32_t loadAddr;
+
+    if (!GetLoadAddress(uiPort, loadAddr)) {
+        return;
+    }
 
     SimpleDataSource dataSource(fileData, fileLen, loadAddr);
 
@@ -324,6 +557,26 @@ void LoadSimpleFile(Port& uiPort, const char * fileName, const uint8_t * fileDat
     char nameBuf[sizeof(nameFormat) + MAX_FILE_NAME_LEN + 10 + 6];
     snprintf(nameBuf, sizeof(nameBuf), nameFormat, fileName, fileLen, loadAddr);
 
+    // If high-speed loading is enabled, load the file via the resident
+    // high-speed loader.
+    if (Settings::HighSpeedLoad && HighSpeedLoad(uiPort, dataSource, nameBuf)) {
+        return;
+    }
+
+    // If fast loading is enabled, and it would be quicker to do so, load the
+    // file using the Absolute Loader, presenting the file to it as an LDA
+    // format tape that is generated on the fly.  The tape image must outlive
+    // this function, since the tape remains mounted after it returns.
+    if (Settings::FastLoad &&
+        FastLoad(uiPort, dataSource, BinaryLDATape::TapeLength(fileLen), loadAddr + fileLen, [&]() {
+            static BinaryLDATape sBinaryTape;
+            PaperTapeReader::Unmount();
+            sBinaryTape = BinaryLDATape(fileData, fileLen, (uint16_t)loadAddr);
+            PaperTapeReader::Mount(fileName, sBinaryTape);
+        })) {
+        return;
+    }
+
     LoadFileMode(uiPort, dataSource, nameBuf);
 }
 
@@ -345,14 +598,284 @@ void LoadPreviouslyUploadedFile(Port& uiPort)
     }
 }
 
-char SelectFile(Port& uiPort, const char * title, bool includeBootstrap)
+void LoadQueue(Port& uiPort)
 {
-    const Menu * fileMenu = BuildFileMenu(title, includeBootstrap);
+    static MenuItem sMenuItems[LOAD_QUEUE_MAX_FILES + 8];
+    static char sEntryNames[LOAD_QUEUE_MAX_FILES][MAX_FILE_NAME_LEN + 50];
+    static Menu sMenu = {
+        .Title = "LOAD QUEUE:",
+        .Items = sMenuItems,
+        .NumCols = 1,
+        .ColWidth = -1,
+        .ColMargin = 2
+    };
+
+    while (true) {
+        MenuItem * item = sMenuItems;
+
+        // List the queued files in the order they will be loaded.
+        if (sLoadQueueLen > 0) {
+            for (size_t i = 0; i < sLoadQueueLen; i++) {
+                GetLoadQueueEntryName(sLoadQueue[i], sEntryNames[i], sizeof(sEntryNames[i]));
+                *item++ = MenuItem::SEPARATOR(sEntryNames[i]);
+            }
+        }
+        else {
+            *item++ = MenuItem::SEPARATOR("(queue empty)");
+        }
+
+        *item++ = MenuItem::SEPARATOR();
+
+        if (sLoadQueueLen < LOAD_QUEUE_MAX_FILES) {
+            *item++ = (MenuItem){ 'a', "Add file to queue" };
+        }
+        if (sLoadQueueLen > 0) {
+            *item++ = (MenuItem){ 'r', "Run queue" };
+            *item++ = (MenuItem){ 'c', "Clear queue" };
+        }
+        *item++ = (MenuItem){ '\e', "Return to terminal mode" };
+        *item++ = MenuItem::HIDDEN(CTRL_C);
+        *item++ = MenuItem::END();
+
+        sMenu.Show(uiPort);
+
+        switch (sMenu.GetSelection(uiPort)) {
+        case 'a':
+            AddToLoadQueue(uiPort);
+            break;
+        case 'c':
+            sLoadQueueLen = 0;
+            break;
+        case 'r':
+            RunLoadQueue(uiPort);
+            return;
+        default:
+            return;
+        }
+    }
+}
+
+void AddToLoadQueue(Port& uiPort)
+{
+    LoadQueueEntry entry;
+    const char *fileName;
+    const uint8_t *fileData;
+    size_t fileLen;
+
+    char sel = SelectFile(uiPort, "ADD FILE TO LOAD QUEUE:", kQueueFileMenu);
+    switch (sel) {
+    case 'X':
+        if (!UploadFileMode(uiPort)) {
+            return;
+        }
+        /* fall through */
+    case 'P':
+        entry.FileIndex = LoadQueueEntry::kUploadedFile;
+        if (!LDAReader::IsValidLDAFile(gUploadedFile, gUploadedFileLen)) {
+            TrimXMODEMPadding();
+        }
+        fileData = gUploadedFile;
+        fileLen = gUploadedFileLen;
+        break;
+    case CTRL_C:
+    case '\e':
+        return;
+    default:
+        entry.FileIndex = SelectorToFileIndex(sel);
+        FileLib::GetFile(entry.FileIndex, fileName, fileData, fileLen);
+        break;
+    }
+
+    // LDA files carry their own load addresses; for all other files, ask
+    // where the file should be loaded.
+    if (LDAReader::IsValidLDAFile(fileData, fileLen)) {
+        entry.LoadAddr = LoadQueueEntry::kLDAFile;
+    }
+    else if (!GetLoadAddress(uiPort, entry.LoadAddr)) {
+        return;
+    }
+
+    sLoadQueue[sLoadQueueLen++] = entry;
+}
+
+void RunLoadQueue(Port& uiPort)
+{
+    static uint32_t sStartAddr = 1;
+    char nameBuf[MAX_FILE_NAME_LEN + 50];
+    const char *fileName;
+    const uint8_t *fileData;
+    size_t fileLen;
+    uint32_t startAddr;
+    bool success = true;
+
+    // Stage each queued file in turn into a single memory image, such that
+    // words from later files replace any words at the same addresses from
+    // earlier files.
+    BeginBatchLoad();
+    for (size_t i = 0; success && i < sLoadQueueLen; i++) {
+        const LoadQueueEntry& entry = sLoadQueue[i];
+
+        if (entry.FileIndex == LoadQueueEntry::kUploadedFile) {
+            fileData = gUploadedFile;
+            fileLen = gUploadedFileLen;
+        }
+        else {
+            FileLib::GetFile(entry.FileIndex, fileName, fileData, fileLen);
+        }
+
+        uiPort.Printf(TITLE_PREFIX "STAGING %s\r\n",
+                      GetLoadQueueEntryName(entry, nameBuf, sizeof(nameBuf)));
+
+        // Fail if the previously uploaded file has since been replaced by
+        // something unusable.
+        if (fileLen == 0 ||
+            LDAReader::IsValidLDAFile(fileData, fileLen) != (entry.LoadAddr == LoadQueueEntry::kLDAFile)) {
+            uiPort.Write(TITLE_PREFIX "ERROR (uploaded file has changed)\r\n");
+            success = false;
+        }
+        else {
+            if (entry.LoadAddr == LoadQueueEntry::kLDAFile) {
+                LDADataSource dataSource(fileData, fileLen);
+                success = AddToBatchLoad(dataSource);
+            }
+            else {
+                SimpleDataSource dataSource(fileData, fileLen, (uint16_t)entry.LoadAddr);
+                success = AddToBatchLoad(dataSource);
+            }
+            if (!success) {
+                uiPort.Printf(TITLE_PREFIX "ERROR (queued files too large to load together; limit is %u KW)\r\n",
+                              (unsigned)(MEMORY_IMAGE_MAX_PAGES / 16));
+            }
+        }
+    }
+    if (!success) {
+        BeginBatchLoad();
+        return;
+    }
+
+    uiPort.Printf(TITLE_PREFIX "STAGED %" PRIu32 " WORDS FROM %zu FILES\r\n",
+                  BatchLoadWordCount(), sLoadQueueLen);
+
+    // Ask for the address at which the program should be started, defaulting
+    // to the start address of the last queued file to specify one.  As with
+    // LDA files, an odd address means the program has no start address.
+    if (BatchLoadStartAddress() != NO_ADDR) {
+        sStartAddr = BatchLoadStartAddress();
+    }
+    do {
+        uiPort.Write(INPUT_PROMPT "INPUT START ADDRESS (in octal, odd for none): " );
+        if (!GetInteger(uiPort, startAddr, 8, sStartAddr)) {
+            return;
+        }
+    } while (startAddr > UINT16_MAX);
+
+    sStartAddr = startAddr;
+
+    snprintf(nameBuf, sizeof(nameBuf), "Load queue (%zu files)", sLoadQueueLen);
+
+    BatchLoadMode(uiPort, nameBuf, (startAddr & 1) == 0 ? (uint16_t)startAddr : NO_ADDR);
+}
+
+const char * GetLoadQueueEntryName(const LoadQueueEntry& entry, char * buf, size_t bufSize)
+{
+    const char *fileName;
+    const uint8_t *fileData;
+    size_t fileLen;
+
+    if (entry.FileIndex == LoadQueueEntry::kUploadedFile) {
+        fileName = "UPLOADED FILE";
+        fileLen = gUploadedFileLen;
+    }
+    else {
+        FileLib::GetFile(entry.FileIndex, fileName, fileData, fileLen);
+    }
+
+    if (entry.LoadAddr == LoadQueueEntry::kLDAFile) {
+        snprintf(buf, bufSize, "%s (LDA format, %u bytes)", fileName, (unsigned)fileLen);
+    }
+    else {
+        snprintf(buf, bufSize, "%s (binary format, %u bytes, load address %06" PRIo32 ")",
+                 fileName, (unsigned)fileLen, entry.LoadAddr);
+    }
+
+    return buf;
+}
+
+void DumpMemory(Port& uiPort)
+{
+    static uint32_t sStartAddr = 0;
+    static uint32_t sEndAddr = 0;
+    static const MenuItem sMenuItems[] = {
+        { 'l', "Absolute Loader (LDA) format"   },
+        { 'r', "Raw binary"                     },
+        { '\e', "Discard dump"                  },
+        MenuItem::HIDDEN(CTRL_C),
+        MenuItem::END()
+    };
+    static const Menu sMenu = {
+        .Title = "DOWNLOAD DUMP VIA XMODEM AS:",
+        .Items = sMenuItems,
+        .NumCols = 1,
+        .ColWidth = -1,
+        .ColMargin = 2
+    };
+    uint32_t startAddr, endAddr;
+
+    do {
+        uiPort.Write(INPUT_PROMPT "INPUT START ADDRESS (in octal): " );
+        if (!GetInteger(uiPort, startAddr, 8, sStartAddr)) {
+            return;
+        }
+    } while (startAddr > UINT16_MAX);
+
+    do {
+        uiPort.Write(INPUT_PROMPT "INPUT END ADDRESS (in octal): " );
+        if (!GetInteger(uiPort, endAddr, 8, MAX(sEndAddr, startAddr))) {
+            return;
+        }
+    } while (endAddr > UINT16_MAX || endAddr < startAddr);
+
+    sStartAddr = startAddr;
+    sEndAddr = endAddr;
+
+    // Dump whole words, starting at the word containing the start address
+    // and ending with the word containing the end address.
+    startAddr &= ~1U;
+    size_t wordCount = (endAddr - startAddr) / 2 + 1;
+
+    // Collect the dumped words in the file upload buffer, discarding any
+    // previously uploaded file.
+    if (PaperTapeReader::TapeDataBuf() == gUploadedFile) {
+        PaperTapeReader::Unmount();
+    }
+    gUploadedFileLen = 0;
+
+    if (!DumpMemoryMode(uiPort, (uint16_t)startAddr, wordCount, gUploadedFile)) {
+        return;
+    }
+
+    sMenu.Show(uiPort);
+
+    switch (sMenu.GetSelection(uiPort)) {
+    case 'l':
+        DownloadFileMode(uiPort, BinaryLDATape(gUploadedFile, wordCount * 2, (uint16_t)startAddr));
+        break;
+    case 'r':
+        DownloadFileMode(uiPort, BufferTapeImage(gUploadedFile, wordCount * 2));
+        break;
+    default:
+        break;
+    }
+}
+
+char SelectFile(Port& uiPort, const char * title, FileMenu_t menuType)
+{
+    const Menu * fileMenu = BuildFileMenu(title, menuType);
     fileMenu->Show(uiPort);
     return fileMenu->GetSelection(uiPort);
 }
 
-const Menu * BuildFileMenu(const char * title, bool includeBootstrap)
+const Menu * BuildFileMenu(const char * title, FileMenu_t menuType)
 {
     static MenuItem sMenuItems[MAX_FILES + 10];
     static Menu sMenu = {
@@ -378,9 +901,11 @@ const Menu * BuildFileMenu(const char * title, bool includeBootstrap)
 
     *item++ = MenuItem::SEPARATOR();
 
-    *item++ = (MenuItem){ 'A', "Absolute Loader" };
+    if (menuType != kQueueFileMenu) {
+        *item++ = (MenuItem){ 'A', "Absolute Loader" };
+    }
 
-    if (includeBootstrap) {
+    if (menuType == kLoadFileMenu) {
         *item++ = (MenuItem){ 'B', "Bootstrap Loader" };
     }
 
@@ -389,7 +914,19 @@ const Menu * BuildFileMenu(const char * title, bool includeBootstrap)
         *item++ = (MenuItem){ 'P', "Previously uploaded file" };
     }
 
-    *item++ = (MenuItem){ '\e', "Return to terminal mode" };
+    if (menuType == kLoadFileMenu) {
+        *item++ = (MenuItem){ 'Q', "Load queue" };
+    }
+
+    if (menuType == kLoadFileMenu && CanResumeLoad()) {
+        *item++ = (MenuItem){ 'R', "Resume interrupted load" };
+    }
+
+    if (menuType == kLoadFileMenu) {
+        *item++ = (MenuItem){ 'M', "System memory size" };
+    }
+
+    *item++ = (MenuItem){ '\e', (menuType == kQueueFileMenu) ? "Return to load queue" : "Return to terminal mode" };
 
     *item++ = MenuItem::HIDDEN(CTRL_C);
 
@@ -406,6 +943,18 @@ void SettingsMenu(Port& uiPort)
     static char sAuxConfigFollowsHostValue[30];
     static char sShowPTRProgressValue[30];
     static char sUppercaseModeValue[30];
+    static char sInputPacingValue[30];
+    static char sEchoTimeoutValue[30];
+    static char sPaceCharDelayValue[30];
+    static char sPaceLineDelayValue[30];
+    static char sPaceBurstSizeValue[30];
+    static char sHostOverflowPolicyValue[30];
+    static char sAuxOverflowPolicyValue[30];
+    static char sFastLoadValue[30];
+    static char sHighSpeedLoadValue[30];
+    static char sVerifyLoadValue[30];
+    static char sClearZeroRunsValue[30];
+    static char sConsoleEntryAddrValue[30];
 
     static const MenuItem sMenuItems[] = {
         { 's', "Default SCL config", sSCLConfigValue            },
@@ -414,6 +963,18 @@ void SettingsMenu(Port& uiPort)
         { 'a', "Default AUX config", sAuxConfigValue            },
         { 'A', "AUX follows USB",    sAuxConfigFollowsHostValue },
         { 'u', "Uppercase mode",     sUppercaseModeValue        },
+        { 'i', "Input pacing",       sInputPacingValue          },
+        { 'e', "Echo timeout",       sEchoTimeoutValue          },
+        { 'c', "Pacing char delay",  sPaceCharDelayValue        },
+        { 'l', "Pacing line delay",  sPaceLineDelayValue        },
+        { 'b', "Pacing burst size",  sPaceBurstSizeValue        },
+        { 'o', "USB overflow",       sHostOverflowPolicyValue   },
+        { 'O', "AUX overflow",       sAuxOverflowPolicyValue    },
+        { 'f', "Fast load",          sFastLoadValue             },
+        { 'h', "High-speed load",    sHighSpeedLoadValue        },
+        { 'v', "Verify loads",       sVerifyLoadValue           },
+        { 'z', "Clear zero runs",    sClearZeroRunsValue        },
+        { 'Z', "Console entry addr", sConsoleEntryAddrValue     },
         MenuItem::SEPARATOR(),
         { '\e', "Return to terminal mode"                       },
         MenuItem::HIDDEN(CTRL_C),
@@ -436,6 +997,18 @@ void SettingsMenu(Port& uiPort)
         ToString(Settings::AuxConfigFollowsUSB, sAuxConfigFollowsHostValue, sizeof(sAuxConfigFollowsHostValue));
         ToString(Settings::ShowPTRProgress, sShowPTRProgressValue, sizeof(sShowPTRProgressValue));
         ToString(Settings::UppercaseMode, sUppercaseModeValue, sizeof(sUppercaseModeValue));
+        ToString(Settings::InputPacing, sInputPacingValue, sizeof(sInputPacingValue));
+        snprintf(sEchoTimeoutValue, sizeof(sEchoTimeoutValue), "%" PRIu32 " ms", Settings::EchoTimeoutMS);
+        snprintf(sPaceCharDelayValue, sizeof(sPaceCharDelayValue), "%" PRIu32 " ms", Settings::PaceCharDelayMS);
+        snprintf(sPaceLineDelayValue, sizeof(sPaceLineDelayValue), "%" PRIu32 " ms", Settings::PaceLineDelayMS);
+        snprintf(sPaceBurstSizeValue, sizeof(sPaceBurstSizeValue), "%" PRIu32, Settings::PaceBurstSize);
+        ToString(Settings::HostOverflowPolicy, sHostOverflowPolicyValue, sizeof(sHostOverflowPolicyValue));
+        ToString(Settings::AuxOverflowPolicy, sAuxOverflowPolicyValue, sizeof(sAuxOverflowPolicyValue));
+        ToString(Settings::FastLoad, sFastLoadValue, sizeof(sFastLoadValue));
+        ToString(Settings::HighSpeedLoad, sHighSpeedLoadValue, sizeof(sHighSpeedLoadValue));
+        ToString(Settings::VerifyLoad, sVerifyLoadValue, sizeof(sVerifyLoadValue));
+        ToString(Settings::ClearZeroRuns, sClearZeroRunsValue, sizeof(sClearZeroRunsValue));
+        snprintf(sConsoleEntryAddrValue, sizeof(sConsoleEntryAddrValue), "%06" PRIo16, Settings::ConsoleEntryAddr);
 
         sMenu.Show(uiPort);
 
@@ -468,6 +1041,60 @@ void SettingsMenu(Port& uiPort)
         case 'u':
             Settings::UppercaseMode = !Settings::UppercaseMode;
             break;
+        case 'i':
+            if (!GetInputPacing(uiPort, Settings::InputPacing)) {
+                continue;
+            }
+            break;
+        case 'e':
+            if (!GetNumericSetting(uiPort, INPUT_PROMPT "INPUT ECHO TIMEOUT (in ms): ", MIN_ECHO_TIMEOUT_MS, MAX_ECHO_TIMEOUT_MS, Settings::EchoTimeoutMS)) {
+                continue;
+            }
+            break;
+        case 'c':
+            if (!GetNumericSetting(uiPort, INPUT_PROMPT "INPUT CHARACTER DELAY (in ms): ", 0, MAX_PACE_DELAY_MS, Settings::PaceCharDelayMS)) {
+                continue;
+            }
+            break;
+        case 'l':
+            if (!GetNumericSetting(uiPort, INPUT_PROMPT "INPUT LINE DELAY (in ms): ", 0, MAX_PACE_DELAY_MS, Settings::PaceLineDelayMS)) {
+                continue;
+            }
+            break;
+        case 'b':
+            if (!GetNumericSetting(uiPort, INPUT_PROMPT "INPUT BURST SIZE (in characters): ", MIN_PACE_BURST_SIZE, MAX_PACE_BURST_SIZE, Settings::PaceBurstSize)) {
+                continue;
+            }
+            break;
+        case 'o':
+            if (!GetOverflowPolicy(uiPort, "USB PORT OVERFLOW POLICY:", Settings::HostOverflowPolicy)) {
+                continue;
+            }
+            break;
+        case 'O':
+            if (!GetOverflowPolicy(uiPort, "AUX PORT OVERFLOW POLICY:", Settings::AuxOverflowPolicy)) {
+                continue;
+            }
+            break;
+        case 'f':
+            Settings::FastLoad = !Settings::FastLoad;
+            break;
+        case 'h':
+            Settings::HighSpeedLoad = !Settings::HighSpeedLoad;
+            break;
+        case 'v':
+            if (!GetVerifyLoad(uiPort, Settings::VerifyLoad)) {
+                continue;
+            }
+            break;
+        case 'z':
+            Settings::ClearZeroRuns = !Settings::ClearZeroRuns;
+            break;
+        case 'Z':
+            if (!GetConsoleEntryAddr(uiPort, Settings::ConsoleEntryAddr)) {
+                continue;
+            }
+            break;
         default:
             return;
         }
@@ -488,6 +1115,7 @@ void DiagMenu(Port& uiPort)
         { 'b', "BASIC I/O TEST"                 },
         { 'r', "READER RUN INTERFACE TEST"      },
         { 's', "SETTINGS TEST"                  },
+        { 't', "TAPE READER STATS"              },
         MenuItem::SEPARATOR(),
         { '\e', "Return to terminal mode"       },
         MenuItem::HIDDEN(CTRL_C),
@@ -514,6 +1142,51 @@ void DiagMenu(Port& uiPort)
     case 's':
         DiagMode_SettingsTest(uiPort);
         break;
+    case 't':
+        DiagMode_TapeReaderStats(uiPort);
+        break;
+    default:
+        break;
+    }
+}
+
+void SystemMemorySizeMenu(Port& uiPort)
+{
+    uint32_t memSizeKW;
+    static char sTitle[50];
+    static const MenuItem sMenuItems[] = {
+        { 'p', "Probe memory size"              },
+        { 'e', "Enter memory size"              },
+        MenuItem::SEPARATOR(),
+        { '\e', "Return to terminal mode"       },
+        MenuItem::HIDDEN(CTRL_C),
+        MenuItem::END()
+    };
+    static const Menu sMenu = {
+        .Title = sTitle,
+        .Items = sMenuItems,
+        .NumCols = 1,
+        .ColWidth = -1,
+        .ColMargin = 2
+    };
+
+    if (sMemSizeState == kMemSizeKnown) {
+        snprintf(sTitle, sizeof(sTitle), "SYSTEM MEMORY SIZE: %" PRIu32 " KW", sMemSizeKW);
+    }
+    else {
+        snprintf(sTitle, sizeof(sTitle), "SYSTEM MEMORY SIZE: unknown");
+    }
+
+    sMenu.Show(uiPort);
+
+    switch (sMenu.GetSelection(uiPort)) {
+    case 'p':
+        sMemSizeState = kMemSizeUnknown;
+        GetSystemMemorySize(uiPort, memSizeKW);
+        break;
+    case 'e':
+        InputSystemMemorySize(uiPort);
+        break;
     default:
         break;
     }
@@ -521,16 +1194,99 @@ void DiagMenu(Port& uiPort)
 
 bool GetSystemMemorySize(Port& uiPort, uint32_t& memSizeKW)
 {
-    static uint32_t sDefaultMemSizeKW = 28;
+    // The first time the memory size is needed, determine it by probing for
+    // memory via the console.  If probing fails, or is interrupted, don't
+    // probe again for the rest of the session (the user can request a new
+    // probe from the Load File menu).
+    if (sMemSizeState == kMemSizeUnknown) {
+        uint32_t probedSizeKW;
+        if (ProbeMemoryMode(uiPort, probedSizeKW)) {
+            sMemSizeKW = probedSizeKW;
+            sMemSizeState = kMemSizeKnown;
+        }
+        else {
+            sMemSizeState = kMemSizeProbeFailed;
+        }
+    }
+
+    // Once the memory size is known, use it for the rest of the session.
+    if (sMemSizeState == kMemSizeKnown) {
+        memSizeKW = sMemSizeKW;
+        uiPort.Printf(TITLE_PREFIX "SYSTEM MEMORY SIZE: %" PRIu32 " KW\r\n", memSizeKW);
+        return true;
+    }
+
+    // Otherwise ask the user for the memory size.
+    if (!InputSystemMemorySize(uiPort)) {
+        return false;
+    }
+    memSizeKW = sMemSizeKW;
+
+    return true;
+}
+
+bool InputSystemMemorySize(Port& uiPort)
+{
+    uint32_t memSizeKW;
 
     do {
         uiPort.Write(INPUT_PROMPT "INPUT SYSTEM MEMORY SIZE (in KW): ");
-        if (!GetInteger(uiPort, memSizeKW, 10, sDefaultMemSizeKW)) {
+        if (!GetInteger(uiPort, memSizeKW, 10, sMemSizeKW)) {
             return false;
         }
     } while (memSizeKW < 4 || memSizeKW > 28);
 
-    sDefaultMemSizeKW = memSizeKW;
+    // The entered size is used for the rest of the session.
+    sMemSizeKW = memSizeKW;
+    sMemSizeState = kMemSizeKnown;
+
+    return true;
+}
+
+bool GetNumericSetting(Port& uiPort, const char * prompt, uint32_t minVal, uint32_t maxVal, uint32_t& val)
+{
+    uint32_t newVal;
+
+    do {
+        uiPort.Write(prompt);
+        if (!GetInteger(uiPort, newVal, 10, val)) {
+            return false;
+        }
+    } while (newVal < minVal || newVal > maxVal);
+
+    val = newVal;
+
+    return true;
+}
+
+bool GetConsoleEntryAddr(Port& uiPort, uint16_t& addr)
+{
+    uint32_t newAddr;
+
+    do {
+        uiPort.Write(INPUT_PROMPT "INPUT CONSOLE ENTRY ADDRESS (in octal): " );
+        if (!GetInteger(uiPort, newAddr, 8, addr)) {
+            return false;
+        }
+    } while (newAddr > UINT16_MAX || (newAddr & 1) != 0);
+
+    addr = (uint16_t)newAddr;
+
+    return true;
+}
+
+bool GetLoadAddress(Port& uiPort, uint32_t& loadAddr)
+{
+    static uint32_t sDefaultLoadAddr = 0;
+
+    do {
+        uiPort.Write(INPUT_PROMPT "INPUT LOAD ADDRESS (in octal): " );
+        if (!GetInteger(uiPort, loadAddr, 8, sDefaultLoadAddr)) {
+            return false;
+        }
+    } while (loadAddr > UINT16_MAX);
+
+    sDefaultLoadAddr = loadAddr;
 
     return true;
 }
@@ -709,6 +1465,111 @@ bool GetShowPTRProgress(Port& uiPort, Settings::ShowPTRProgress_t& showProgressB
     }
 }
 
+bool GetVerifyLoad(Port& uiPort, Settings::VerifyLoad_t& verifyLoad)
+{
+    static const MenuItem sMenuItems[] = {
+        { '0', "Off"                },
+        { '1', "Verify"             },
+        { '2', "Verify and repair"  },
+        MenuItem::HIDDEN(CTRL_C),
+        MenuItem::HIDDEN('\e'),
+        MenuItem::END()
+    };
+    static const Menu sMenu = {
+        .Title = "VERIFY MEMORY AFTER LOADING:",
+        .Items = sMenuItems,
+        .NumCols = 1,
+        .ColWidth = -1,
+        .ColMargin = 2
+    };
+
+    sMenu.Show(uiPort);
+
+    switch (sMenu.GetSelection(uiPort)) {
+    case '0':
+        verifyLoad = Settings::VerifyLoad_Off;
+        return true;
+    case '1':
+        verifyLoad = Settings::VerifyLoad_On;
+        return true;
+    case '2':
+        verifyLoad = Settings::VerifyLoad_Repair;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool GetInputPacing(Port& uiPort, Settings::InputPacing_t& inputPacing)
+{
+    static const MenuItem sMenuItems[] = {
+        { '0', "Off"                },
+        { '1', "Echo"               },
+        { '2', "Fixed rate"         },
+        MenuItem::HIDDEN(CTRL_C),
+        MenuItem::HIDDEN('\e'),
+        MenuItem::END()
+    };
+    static const Menu sMenu = {
+        .Title = "INPUT PACING:",
+        .Items = sMenuItems,
+        .NumCols = 1,
+        .ColWidth = -1,
+        .ColMargin = 2
+    };
+
+    sMenu.Show(uiPort);
+
+    switch (sMenu.GetSelection(uiPort)) {
+    case '0':
+        inputPacing = Settings::InputPacing_Off;
+        return true;
+    case '1':
+        inputPacing = Settings::InputPacing_Echo;
+        return true;
+    case '2':
+        inputPacing = Settings::InputPacing_Fixed;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool GetOverflowPolicy(Port& uiPort, const char * title, Port::OverflowPolicy_t& policy)
+{
+    static const MenuItem sMenuItems[] = {
+        { '0', "Block"              },
+        { '1', "Drop oldest"        },
+        { '2', "Drop newest"        },
+        MenuItem::HIDDEN(CTRL_C),
+        MenuItem::HIDDEN('\e'),
+        MenuItem::END()
+    };
+    const Menu menu = {
+        .Title = title,
+        .Items = sMenuItems,
+        .NumCols = 1,
+        .ColWidth = -1,
+        .ColMargin = 2
+    };
+
+    menu.Show(uiPort);
+
+    switch (menu.GetSelection(uiPort)) {
+    case '0':
+        policy = Port::OverflowPolicy_Block;
+        return true;
+    case '1':
+        policy = Port::OverflowPolicy_DropOldest;
+        return true;
+    case '2':
+        policy = Port::OverflowPolicy_DropNewest;
+        return true;
+    default:
+        return false;
+    }
+}
+
 const char * ToString(const SerialConfig& serialConfig, char * buf, size_t bufSize)
 {
     snprintf(buf, bufSize, "%" PRIu32 "-%" PRIu8 "-%c-%" PRIu8,
@@ -740,4 +1601,46 @@ const char * ToString(Settings::ShowPTRProgress_t val, char * buf, size_t bufSiz
     }
     strncpy(buf, valStr, bufSize);
     return buf;
+}
+
+const char * ToString(Settings::VerifyLoad_t val, char * buf, size_t bufSize)
+{
+    const char * valStr;
+
+    switch (val) {
+    case Settings::VerifyLoad_On:     valStr = "on";     break;
+    case Settings::VerifyLoad_Repair: valStr = "repair"; break;
+    default:
+    case Settings::VerifyLoad_Off:    valStr = "off";    break;
+    }
+    strncpy(buf, valStr, bufSize);
+    return buf;
+}
+
+const char * ToString(Settings::InputPacing_t val, char * buf, size_t bufSize)
+{
+    const char * valStr;
+
+    switch (val) {
+    case Settings::InputPacing_Echo:  valStr = "echo";       break;
+    case Settings::InputPacing_Fixed: valStr = "fixed rate"; break;
+    default:
+    case Settings::InputPacing_Off:   valStr = "off";        break;
+    }
+    strncpy(buf, valStr, bufSize);
+    return buf;
+}
+
+const char * ToString(Port::OverflowPolicy_t val, char * buf, size_t bufSize)
+{
+    const char * valStr;
+
+    switch (val) {
+    case Port::OverflowPolicy_DropOldest: valStr = "drop oldest"; break;
+    case Port::OverflowPolicy_DropNewest: valStr = "drop newest"; break;
+    default:
+    case Port::OverflowPolicy_Block:      valStr = "block";       break;
+    }
+    strncpy(buf, valStr, bufSize);
+    return buf;
 }
\ No newline at end of file
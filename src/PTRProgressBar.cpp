@@ -17,6 +17,7 @@
 #include "ConsoleAdapter.h"
 #include "PTRProgressBar.h"
 #include "Settings.h"
+#include "Core1.h"
 
 int PTRProgressBar::sState = PROGRESS_BAR_INACTIVE;
 Port * PTRProgressBar::sPort;
@@ -44,6 +45,11 @@ void PTRProgressBar::Update(Port * uiPort)
             sState = 0;
             sPort = uiPort;
 
+            // Hold off forwarding of output from the PDP-11 while the
+            // progress bar is displayed, so that it doesn't get mixed
+            // into the progress bar.
+            Core1::SuspendForwarding();
+
             // Display an empty progress bar
             sPort->Printf("%s%*s%s", 
                 PROGRESS_BAR_PREFIX, PROGRESS_BAR_WIDTH, "", PROGRESS_BAR_SUFFIX);
@@ -93,5 +99,7 @@ void PTRProgressBar::Clear(void)
 
         sState = PROGRESS_BAR_INACTIVE;
         sPort = NULL;
+
+        Core1::ResumeForwarding();
     }
 }
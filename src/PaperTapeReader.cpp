@@ -14,68 +14,245 @@
  * limitations under the License.
  */
 
+#include <inttypes.h>
+
 #include "ConsoleAdapter.h"
 #include "PaperTapeReader.h"
 #include "UploadFileMode.h"
 
 const char * PaperTapeReader::sName;
 const uint8_t * PaperTapeReader::sData;
+const TapeImage * PaperTapeReader::sImage;
 size_t PaperTapeReader::sLength;
 size_t PaperTapeReader::sStartOffset;
 size_t PaperTapeReader::sReadPos;
+volatile uint32_t PaperTapeReader::sReadCount;
+critical_section_t PaperTapeReader::sLock;
+PaperTapeReader::Stats PaperTapeReader::sStats;
 
 void PaperTapeReader::Init(void)
 {
-    // nothing to do
+    // Initialize the lock used to serialize access to the reader state.
+    // This is necessary because, in dual-core mode, the tape is read by
+    // core1 while it is mounted/unmounted by core0.
+    //
+    // ServiceReaderRun() writes to the SCL port, acquiring the port's
+    // transmit lock, while holding this lock.  Because nesting two critical
+    // sections that share a spin lock deadlocks, both locks use dedicated
+    // spin locks rather than the SDK's shared (striped) ones.
+    critical_section_init_with_lock_num(&sLock, (uint)spin_lock_claim_unused(true));
 }
 
 bool PaperTapeReader::TryRead(char& ch)
 {
+    bool res = false;
+
+    critical_section_enter_blocking(&sLock);
+
     // If not at the end of the tape...
     if (IsMounted() && sReadPos < sLength) {
 
         // Read the next character from the tape
-        ch = (char)sData[sStartOffset + sReadPos];
+        ch = (char)ReadTapeByte(sReadPos);
         sReadPos++;
+        sReadCount++;
         
         // Automatically unmount the tape when the end is reached
         if (sReadPos == sLength) {
-            Unmount();
+            Reset();
         }
 
-        return true;
+        res = true;
     }
     else {
         ch = 0;
-        return false;
     }
+
+    critical_section_exit(&sLock);
+
+    return res;
+}
+
+void PaperTapeReader::ServiceReaderRun(void)
+{
+    // NOTE: This function is called both from the main loop and from the
+    // READER RUN interrupt handler.  The lock ensures that bytes are read
+    // from the tape and sent to the SCL port in order.
+    critical_section_enter_blocking(&sLock);
+
+    // For each READER RUN request from the PDP-11, deliver a single byte
+    // from the paper tape to the SCL port, provided there is data available
+    // on the tape and room in the SCL port's transmit buffer.  Requests that
+    // cannot be serviced now are left pending.
+    while (gSCLPort.ReaderRunRequested() && IsMounted() && sReadPos < sLength) {
+        if (!gSCLPort.TryWrite((char)ReadTapeByte(sReadPos))) {
+            sStats.DeferredRequests++;
+            break;
+        }
+        RecordDelivery();
+        gSCLPort.ConsumeReaderRunRequest();
+        sReadPos++;
+        sReadCount++;
+
+        // Automatically unmount the tape when the end is reached
+        if (sReadPos == sLength) {
+            Reset();
+        }
+    }
+
+    critical_section_exit(&sLock);
 }
 
 void PaperTapeReader::Mount(const char * name, const uint8_t * data, size_t len)
 {
+    size_t startOffset = 0;
+
+    // Skip any nul characters at the beginning of the tape image
+    while (len > 0 && data[startOffset] == 0) {
+        startOffset++;
+        len--;
+    }
+
+    // Truncate any nul characters at the end of the tape image
+    while (len > 0 && data[startOffset + len - 1] == 0) {
+        len--;
+    }
+
+    critical_section_enter_blocking(&sLock);
+
     sName = name;
     sData = data;
+    sImage = NULL;
     sLength = len;
+    sStartOffset = startOffset;
+
+    StartTape();
+
+    critical_section_exit(&sLock);
+
+    // Deliver the first byte now if the PDP-11 is already waiting for it.
+    ServiceReaderRun();
+}
+
+void PaperTapeReader::Mount(const char * name, const TapeImage& image)
+{
+    critical_section_enter_blocking(&sLock);
+
+    sName = name;
+    sData = image.DataBuf();
+    sImage = &image;
+    sLength = image.Length();
     sStartOffset = 0;
+
+    StartTape();
+
+    critical_section_exit(&sLock);
+
+    // Deliver the first byte now if the PDP-11 is already waiting for it.
+    ServiceReaderRun();
+}
+
+void PaperTapeReader::StartTape(void)
+{
+    // NOTE: Must be called with sLock held.
+
     sReadPos = 0;
 
-    // Skip any nul characters at the beginning of the tape image
-    while (sLength > 0 && sData[sStartOffset] == 0) {
-        sStartOffset++;
-        sLength--;
-    }
+    // Collapse any READER RUN requests that accumulated while no tape was
+    // mounted into a single request, mimicking the behavior of a physical
+    // reader that is loaded while the PDP-11 is waiting for it.
+    uint32_t pendingRequests = gSCLPort.PendingReaderRunRequests();
+    gSCLPort.CoalesceReaderRunRequests();
 
-    // Truncate any nul characters at the end of the tape image
-    while (sLength > 0 && sData[sStartOffset + sLength - 1] == 0) {
-        sLength--;
-    }
+    // Reset the reader statistics for the new tape.
+    memset(&sStats, 0, sizeof(sStats));
+    sStats.CoalescedRequests = pendingRequests - gSCLPort.PendingReaderRunRequests();
+    sStats.MissedCountBase = gSCLPort.ReaderRunMissedCount();
 }
 
 void PaperTapeReader::Unmount(void)
+{
+    critical_section_enter_blocking(&sLock);
+    Reset();
+    critical_section_exit(&sLock);
+}
+
+void PaperTapeReader::Reset(void)
 {
     sName = NULL;
     sData = NULL;
+    sImage = NULL;
     sLength = 0;
     sStartOffset = 0;
     sReadPos = 0;
 }
+
+void PaperTapeReader::RecordDelivery(void)
+{
+    // NOTE: Must be called with sLock held, before the READER RUN request
+    // being answered has been consumed.
+
+    uint32_t now = time_us_32();
+    uint32_t requestTime = gSCLPort.NextReaderRunTime();
+
+    // Record the time between the PDP-11 requesting the byte and the byte
+    // being queued for transmission.  This is queued latency: the byte
+    // reaches the PDP-11 at least one character time later, once the
+    // transmit DMA has fed it to the UART and it has been sent.
+    uint32_t latencyUS = now - requestTime;
+    sStats.TotalLatencyUS += latencyUS;
+    sStats.MaxLatencyUS = MAX(sStats.MaxLatencyUS, latencyUS);
+    size_t bucket = 0;
+    for (uint32_t limit = 10; bucket < kLatencyBuckets - 1 && latencyUS >= limit; limit *= 10) {
+        bucket++;
+    }
+    sStats.LatencyHist[bucket]++;
+
+    // Record the longest gap between successive requests from the PDP-11.
+    if (sStats.BytesDelivered > 0) {
+        sStats.LongestGapUS = MAX(sStats.LongestGapUS, requestTime - sStats.LastRequestTime);
+    }
+    else {
+        sStats.FirstByteTime = now;
+    }
+    sStats.LastRequestTime = requestTime;
+    sStats.LastByteTime = now;
+    sStats.BytesDelivered++;
+}
+
+void PaperTapeReader::GetStats(Stats& stats)
+{
+    critical_section_enter_blocking(&sLock);
+    stats = sStats;
+    stats.MissedRequests = gSCLPort.ReaderRunMissedCount() - sStats.MissedCountBase;
+    critical_section_exit(&sLock);
+}
+
+void PaperTapeReader::PrintStats(Port& uiPort, const char * indent)
+{
+    Stats stats;
+
+    GetStats(stats);
+
+    uiPort.Printf("%sBytes delivered: %" PRIu32 " (%" PRIu32 " bytes/sec)\r\n",
+        indent, stats.BytesDelivered, stats.BytesPerSecond());
+    uiPort.Printf("%sQueued latency: %" PRIu32 " us avg, %" PRIu32 " us max\r\n",
+        indent, stats.AvgLatencyUS(), stats.MaxLatencyUS);
+    uiPort.Printf("%sLongest gap between requests: %" PRIu32 " ms\r\n",
+        indent, stats.LongestGapUS / 1000);
+    uiPort.Printf("%sRequests deferred: %" PRIu32 ", missed: %" PRIu32 ", coalesced: %" PRIu32 "\r\n",
+        indent, stats.DeferredRequests, stats.MissedRequests, stats.CoalescedRequests);
+}
+
+uint32_t PaperTapeReader::Stats::BytesPerSecond(void) const
+{
+    uint32_t elapsedUS = LastByteTime - FirstByteTime;
+    return (BytesDelivered > 1 && elapsedUS > 0)
+        ? (uint32_t)(((uint64_t)(BytesDelivered - 1) * 1000000) / elapsedUS)
+        : 0;
+}
+
+uint32_t PaperTapeReader::Stats::AvgLatencyUS(void) const
+{
+    return (BytesDelivered > 0) ? (uint32_t)(TotalLatencyUS / BytesDelivered) : 0;
+}
@@ -17,25 +17,93 @@
 #ifndef PAPER_TAPE_READER_H
 #define PAPER_TAPE_READER_H
 
+#include "pico/critical_section.h"
+
+/** A paper tape image whose contents are generated on demand
+ */
+class TapeImage
+{
+public:
+    virtual ~TapeImage(void) = default;
+    virtual size_t Length(void) const = 0;
+    virtual uint8_t ReadByte(size_t pos) const = 0;
+    virtual const uint8_t * DataBuf(void) const = 0;
+};
+
+/** Presents a buffer in memory as a tape image
+ */
+class BufferTapeImage final : public TapeImage
+{
+public:
+    BufferTapeImage(const uint8_t * buf, size_t len) : mDataBuf(buf), mDataLen(len) { }
+    virtual size_t Length(void) const { return mDataLen; }
+    virtual uint8_t ReadByte(size_t pos) const { return mDataBuf[pos]; }
+    virtual const uint8_t * DataBuf(void) const { return mDataBuf; }
+
+private:
+    const uint8_t * mDataBuf;
+    size_t mDataLen;
+};
+
 class PaperTapeReader final
 {
 public:
+    // Number of buckets in the READER RUN latency histogram.  Bucket N counts
+    // bytes queued for transmission within 10^(N+1) us of the PDP-11's
+    // request; the last bucket counts all longer latencies.  Latencies are
+    // measured to the point the byte is queued in the SCL port's transmit
+    // buffer, and so exclude the time taken to send it.
+    static constexpr size_t kLatencyBuckets = 6;
+
+    struct Stats
+    {
+        uint32_t BytesDelivered;
+        uint32_t FirstByteTime;
+        uint32_t LastByteTime;
+        uint32_t LastRequestTime;
+        uint64_t TotalLatencyUS;
+        uint32_t MaxLatencyUS;
+        uint32_t LongestGapUS;
+        uint32_t DeferredRequests;
+        uint32_t MissedRequests;
+        uint32_t CoalescedRequests;
+        uint32_t MissedCountBase;
+        uint32_t LatencyHist[kLatencyBuckets];
+
+        uint32_t BytesPerSecond(void) const;
+        uint32_t AvgLatencyUS(void) const;
+    };
+
     static void Init(void);
     static bool TryRead(char& ch);
+    static void ServiceReaderRun(void);
     static void Mount(const char * tapeName, const uint8_t * data, size_t len);
+    static void Mount(const char * tapeName, const TapeImage& image);
     static void Unmount(void);
     static bool IsMounted(void);
     static const char * TapeName(void);
     static const uint8_t * TapeDataBuf(void);
     static size_t TapeLength(void);
     static size_t TapePosition(void);
+    static uint32_t ReadCount(void);
+    static void GetStats(Stats& stats);
+    static void PrintStats(Port& uiPort, const char * indent);
 
 private:
     static const char * sName;
     static const uint8_t * sData;
+    static const TapeImage * sImage;
     static size_t sLength;
     static size_t sStartOffset;
     static size_t sReadPos;
+    static volatile uint32_t sReadCount;
+    static critical_section_t sLock;
+    static Stats sStats;
+
+    static void Reset(void);
+    static void RecordDelivery(void);
+    static void StartTape(void);
+    static uint8_t ReadTapeByte(size_t pos);
 };
 
 inline
@@ -68,4 +136,16 @@ size_t PaperTapeReader::TapePosition(void)
     return (IsMounted()) ? sReadPos : SIZE_MAX;
 }
 
+inline
+uint32_t PaperTapeReader::ReadCount(void)
+{
+    return sReadCount;
+}
+
+inline
+uint8_t PaperTapeReader::ReadTapeByte(size_t pos)
+{
+    return (sImage != NULL) ? sImage->ReadByte(pos) : sData[sStartOffset + pos];
+}
+
 #endif // PAPER_TAPE_READER_H
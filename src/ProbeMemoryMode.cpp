@@ -0,0 +1,138 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <inttypes.h>
+
+#include "ConsoleAdapter.h"
+#include "M93xxController.h"
+#include "Core1.h"
+
+// Range of system memory sizes (in KW) supported by the PDP-11/05
+constexpr static uint32_t kMinMemSizeKW = 4;
+constexpr static uint32_t kMaxMemSizeKW = 28;
+
+static inline uint16_t LastWordAddr(uint32_t memSizeKW)
+{
+    return (uint16_t)(memSizeKW * 2048 - 2);
+}
+
+bool ProbeMemoryMode(Port& uiPort, uint32_t& memSizeKW)
+{
+    M93xxController m93xxCtr;
+    uint32_t presentKW = kMinMemSizeKW - 1;
+    uint32_t limitKW = kMaxMemSizeKW;
+    uint32_t probeKW = 0;
+    bool examinePending = false;
+    bool probeComplete = false;
+
+    // Keep core1 from forwarding the console's output while it is read here.
+    Core1::SuspendForwarding();
+
+    // Scale the console timeouts to the current SCL baud rate.
+    m93xxCtr.SetCharTime(gSCLPort.GetConfig().CharTimeUS());
+
+    uiPort.Write(TITLE_PREFIX "PROBING SYSTEM MEMORY SIZE (press CTRL+C to enter manually)\r\n");
+
+    while (true) {
+        char ch;
+
+        // Update the state of the activity LEDs
+        ActivityLED::UpdateState();
+
+        // Update the connection status of the SCL port
+        gSCLPort.CheckConnected();
+
+        // Process any timeouts while talking to the M9301/M9312 console;
+        // If the console is unresponsive, abort.
+        if (m93xxCtr.ProcessTimeouts()) {
+            uiPort.Write(TITLE_PREFIX "TIMEOUT (no response from console)\r\n");
+            break;
+        }
+
+        // Check for an interrupt character from the UI port.
+        if (uiPort.TryRead(ch) && ch == CTRL_C) {
+            uiPort.Write(TITLE_PREFIX "INTERRUPTED\r\n");
+            break;
+        }
+
+        // Pass any output from the M9301/M9312 console to the M93xxController
+        // for processing.  The console output is not echoed, since the
+        // register dumps output when probing non-existent memory would only
+        // confuse the user.
+        if (gSCLPort.TryRead(ch) && !m93xxCtr.ProcessOutput(ch)) {
+            uiPort.Write(TITLE_PREFIX "ERROR (unexpected response from console)\r\n");
+            break;
+        }
+
+        // Wait until the M9301/M9312 is ready for another command.
+        if (!m93xxCtr.IsReadyForCommand()) {
+            continue;
+        }
+
+        // If an examine command has completed, the memory containing the
+        // probed word exists if the console examined the word without
+        // faulting.  Narrow the search accordingly.
+        if (examinePending) {
+            examinePending = false;
+            if (!m93xxCtr.LastCommandFaulted() && m93xxCtr.LastCommand() == 'E' &&
+                m93xxCtr.LastAddress() == LastWordAddr(probeKW)) {
+                presentKW = probeKW;
+            }
+            else {
+                limitKW = probeKW - 1;
+            }
+        }
+
+        // Once the largest memory size known to be present is the largest
+        // that could be present, the probe is complete.
+        if (presentKW == limitKW) {
+            probeComplete = true;
+            break;
+        }
+
+        // Binary search for the memory size by examining the last word of
+        // the memory size half way between the known limits, issuing a set
+        // address (L) command beforehand if necessary.
+        probeKW = (presentKW + limitKW + 1) / 2;
+        if (m93xxCtr.NextExamineAddress() != LastWordAddr(probeKW)) {
+            m93xxCtr.SetAddress(LastWordAddr(probeKW));
+            continue;
+        }
+        m93xxCtr.Examine();
+        examinePending = true;
+    }
+
+    Core1::ResumeForwarding();
+
+    // Report any errors in the console's output that were recovered from.
+    if (m93xxCtr.ErrorCount() > 0) {
+        uiPort.Printf(TITLE_PREFIX "CONSOLE ERRORS: %" PRIu32 " (recovered by resynchronizing %" PRIu32 " times)\r\n",
+                      m93xxCtr.ErrorCount(), m93xxCtr.RecoveryCount());
+    }
+
+    if (!probeComplete) {
+        return false;
+    }
+
+    if (presentKW < kMinMemSizeKW) {
+        uiPort.Printf(TITLE_PREFIX "ERROR (less than %" PRIu32 " KW of memory found)\r\n", kMinMemSizeKW);
+        return false;
+    }
+
+    memSizeKW = presentKW;
+    return true;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2024-2025 Jay Logue
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "hardware/sync.h"
+
+/** A fixed-size ring buffer of characters
+ *
+ * RingBuffer is safe to use between an interrupt handler and the main
+ * loop, or between the two cores, without locking, provided that only
+ * one context puts characters into the buffer and only one context gets
+ * characters out of it.
+ *
+ * All methods are forced inline so that they can be used by interrupt
+ * handlers that execute from RAM.
+ *
+ * N must be a power of 2.
+ */
+template <size_t N>
+class RingBuffer final
+{
+public:
+    RingBuffer(void) = default;
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    bool Put(char ch);
+    bool Get(char& ch);
+    size_t Get(char * buf, size_t maxLen);
+    size_t Count(void) const;
+    size_t Space(void) const;
+    bool IsEmpty(void) const;
+    bool IsFull(void) const;
+    void Clear(void);
+
+    static constexpr size_t kSize = N;
+
+private:
+    static_assert(N != 0 && (N & (N - 1)) == 0, "RingBuffer size must be a power of 2");
+
+    char mBuf[N];
+    volatile uint32_t mHead = 0; // Total characters put (modified by producer only)
+    volatile uint32_t mTail = 0; // Total characters gotten (modified by consumer only)
+};
+
+template <size_t N>
+__force_inline bool RingBuffer<N>::Put(char ch)
+{
+    uint32_t head = mHead;
+    if ((head - mTail) >= N) {
+        return false;
+    }
+    mBuf[head & (N - 1)] = ch;
+
+    // Ensure the character is stored before it is made visible to the consumer.
+    __dmb();
+
+    mHead = head + 1;
+    return true;
+}
+
+template <size_t N>
+__force_inline bool RingBuffer<N>::Get(char& ch)
+{
+    uint32_t tail = mTail;
+    if (tail == mHead) {
+        return false;
+    }
+    ch = mBuf[tail & (N - 1)];
+
+    // Ensure the character is read before its slot is released to the producer.
+    __dmb();
+
+    mTail = tail + 1;
+    return true;
+}
+
+template <size_t N>
+__force_inline size_t RingBuffer<N>::Get(char * buf, size_t maxLen)
+{
+    uint32_t tail = mTail;
+    size_t len = MIN((size_t)(mHead - tail), maxLen);
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = mBuf[(tail + i) & (N - 1)];
+    }
+
+    // Ensure the characters are read before their slots are released to the producer.
+    __dmb();
+
+    mTail = tail + (uint32_t)len;
+    return len;
+}
+
+template <size_t N>
+__force_inline size_t RingBuffer<N>::Count(void) const
+{
+    return (size_t)(mHead - mTail);
+}
+
+template <size_t N>
+__force_inline size_t RingBuffer<N>::Space(void) const
+{
+    return N - Count();
+}
+
+template <size_t N>
+__force_inline bool RingBuffer<N>::IsEmpty(void) const
+{
+    return mHead == mTail;
+}
+
+template <size_t N>
+__force_inline bool RingBuffer<N>::IsFull(void) const
+{
+    return Count() >= N;
+}
+
+template <size_t N>
+__force_inline void RingBuffer<N>::Clear(void)
+{
+    // NOTE: Must only be called by the consumer.
+    mTail = mHead;
+}
+
+#endif // RING_BUFFER_H
@@ -23,7 +23,11 @@
 SCLPort gSCLPort;
 
 SerialConfig SCLPort::sConfig = { SCL_DEFAULT_BAUD_RATE, 8, 1, SerialConfig::PARITY_NONE };
-bool SCLPort::sReaderRunRequested;
+volatile uint32_t SCLPort::sReaderRunEdgeCount;
+volatile uint32_t SCLPort::sReaderRunConsumedCount;
+volatile uint32_t SCLPort::sReaderRunTimes[SCL_READER_RUN_TIME_SLOTS];
+volatile uint32_t SCLPort::sReaderRunMissedCount;
+BufferedUART SCLPort::sUARTBuf;
 
 void SCLPort::Init(void)
 {
@@ -33,6 +37,9 @@ void SCLPort::Init(void)
     gpio_set_function(SCL_UART_RX_PIN, UART_FUNCSEL_NUM(SCL_UART, SCL_UART_RX_PIN));
     gpio_set_function(SCL_UART_TX_PIN, UART_FUNCSEL_NUM(SCL_UART, SCL_UART_TX_PIN));
 
+    // Setup interrupt-driven buffering of characters received from the PDP-11
+    sUARTBuf.Init(SCL_UART);
+
     // Setup the SCL clock generator
     uint slice = pwm_gpio_to_slice_num(SCL_CLOCK_PIN);
     gpio_set_function(SCL_CLOCK_PIN, GPIO_FUNC_PWM);
@@ -133,6 +140,24 @@ void SCLPort::HandleReaderRunIRQ(void)
 {
     if ((gpio_get_irq_event_mask(READER_RUN_PIN) & GPIO_IRQ_EDGE_RISE) != 0) {
         gpio_acknowledge_irq(READER_RUN_PIN, GPIO_IRQ_EDGE_RISE);
-        sReaderRunRequested = true;
+
+        // Count each READER RUN request, so that none are lost if a new
+        // request arrives before the previous one has been serviced.  Note
+        // how often this happens, since it would have resulted in a missed
+        // request with a simple request flag.  Record the time of each
+        // request, so that the latency of each delivery can be measured
+        // from the request that it answers.
+        uint32_t edgeCount = sReaderRunEdgeCount;
+        if (edgeCount != sReaderRunConsumedCount) {
+            sReaderRunMissedCount = sReaderRunMissedCount + 1;
+        }
+        sReaderRunTimes[edgeCount % SCL_READER_RUN_TIME_SLOTS] = time_us_32();
+        sReaderRunEdgeCount = edgeCount + 1;
+
+#if defined(READER_RUN_ISR_DELIVERY)
+        // Deliver the next byte from the paper tape directly to the SCL
+        // port, rather than waiting for the main loop to do so.
+        PaperTapeReader::ServiceReaderRun();
+#endif
     }
 }
\ No newline at end of file
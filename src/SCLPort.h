@@ -33,18 +33,31 @@ public:
     void SetConfig(const SerialConfig& serialConfig);
     bool CheckConnected(void);
     bool ReaderRunRequested(void);
-    void ClearReaderRunRequested(void);
+    uint32_t PendingReaderRunRequests(void);
+    void ConsumeReaderRunRequest(void);
+    void CoalesceReaderRunRequests(void);
+    uint32_t NextReaderRunTime(void);
+    uint32_t ReaderRunMissedCount(void);
+    uint32_t RxOverrunCount(void);
+    size_t RxCount(void);
 
     virtual char Read(void);
     virtual bool TryRead(char &ch);
+    virtual size_t ReadSome(char * buf, size_t maxLen);
     virtual void Write(char ch);
     virtual void Write(const char * str);
     virtual void Flush(void);
     virtual bool CanWrite(void);
+    bool TryWrite(char ch);
+    size_t WriteSpace(void);
 
 private:
     static SerialConfig sConfig;
-    static bool sReaderRunRequested;
+    static volatile uint32_t sReaderRunEdgeCount;
+    static volatile uint32_t sReaderRunConsumedCount;
+    static volatile uint32_t sReaderRunTimes[SCL_READER_RUN_TIME_SLOTS];
+    static volatile uint32_t sReaderRunMissedCount;
+    static BufferedUART sUARTBuf;
 
     static void ConfigSCLClock(uint32_t bitRate);
     static void HandleReaderRunIRQ(void);
@@ -59,26 +72,49 @@ inline const SerialConfig& SCLPort::GetConfig(void)
 
 inline bool SCLPort::ReaderRunRequested(void)
 {
-    return sReaderRunRequested;
+    return sReaderRunEdgeCount != sReaderRunConsumedCount;
 }
 
-inline void SCLPort::ClearReaderRunRequested(void)
+inline uint32_t SCLPort::PendingReaderRunRequests(void)
 {
-    sReaderRunRequested = false;
+    return sReaderRunEdgeCount - sReaderRunConsumedCount;
+}
+
+inline void SCLPort::ConsumeReaderRunRequest(void)
+{
+    sReaderRunConsumedCount = sReaderRunConsumedCount + 1;
+}
+
+inline void SCLPort::CoalesceReaderRunRequests(void)
+{
+    uint32_t edgeCount = sReaderRunEdgeCount;
+    if (edgeCount - sReaderRunConsumedCount > 1) {
+        sReaderRunConsumedCount = edgeCount - 1;
+    }
+}
+
+inline uint32_t SCLPort::RxOverrunCount(void)
+{
+    return sUARTBuf.RxOverrunCount();
+}
+
+inline size_t SCLPort::RxCount(void)
+{
+    return sUARTBuf.RxCount();
 }
 
 inline char SCLPort::Read(void)
 {
-    char ch = uart_getc(SCL_UART);
-    ActivityLED::TxActive();
-    ActivityLED::SysActive();
+    char ch;
+    while (!TryRead(ch)) {
+        tight_loop_contents();
+    }
     return ch;
 }
 
 inline bool SCLPort::TryRead(char& ch)
 {
-    if (uart_is_readable(SCL_UART)) {
-        ch = uart_getc(SCL_UART);
+    if (sUARTBuf.TryRead(ch)) {
         ActivityLED::TxActive();
         ActivityLED::SysActive();
         return true;
@@ -86,28 +122,71 @@ inline bool SCLPort::TryRead(char& ch)
     return false;
 }
 
+inline size_t SCLPort::ReadSome(char * buf, size_t maxLen)
+{
+    size_t len = sUARTBuf.ReadSome(buf, maxLen);
+    if (len > 0) {
+        ActivityLED::TxActive();
+        ActivityLED::SysActive();
+    }
+    return len;
+}
+
 inline void SCLPort::Write(char ch)
 {
-    uart_putc(SCL_UART, ch);
+    sUARTBuf.Write(ch);
     ActivityLED::RxActive();
     ActivityLED::SysActive();
 }
 
+inline uint32_t SCLPort::NextReaderRunTime(void)
+{
+    // Return the time of the oldest pending READER RUN request.  If more
+    // requests are pending than there are timestamp slots, the oldest
+    // timestamp that is still retained is returned instead.
+    uint32_t edgeCount = sReaderRunEdgeCount;
+    uint32_t index = sReaderRunConsumedCount;
+    if (edgeCount - index > SCL_READER_RUN_TIME_SLOTS) {
+        index = edgeCount - SCL_READER_RUN_TIME_SLOTS;
+    }
+    return sReaderRunTimes[index % SCL_READER_RUN_TIME_SLOTS];
+}
+
+inline uint32_t SCLPort::ReaderRunMissedCount(void)
+{
+    return sReaderRunMissedCount;
+}
+
+inline bool SCLPort::TryWrite(char ch)
+{
+    if (sUARTBuf.TryWrite(ch)) {
+        ActivityLED::RxActive();
+        ActivityLED::SysActive();
+        return true;
+    }
+    return false;
+}
+
 inline void SCLPort::Write(const char* str)
 {
-    uart_puts(SCL_UART, str);
+    sUARTBuf.Write(str);
     ActivityLED::RxActive();
     ActivityLED::SysActive();
 }
 
 inline void SCLPort::Flush(void)
 {
-    uart_tx_wait_blocking(SCL_UART);
+    sUARTBuf.Flush();
 }
 
 inline bool SCLPort::CanWrite(void)
 {
-    return uart_is_writable(SCL_UART);
+    return sUARTBuf.CanWrite();
+}
+
+inline size_t SCLPort::WriteSpace(void)
+{
+    return sUARTBuf.TxSpace();
 }
 
 #endif // SCL_PORT_H
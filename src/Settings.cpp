@@ -19,6 +19,7 @@
 #include "ConsoleAdapter.h"
 #include "Settings.h"
 #include "Menu.h"
+#include "Core1.h"
 
 #include "hardware/flash.h"
 #include "hardware/sync.h"
@@ -66,7 +67,32 @@ struct alignas(uint64_t) SettingsRecord_V2 final : public SettingsRecord
     static constexpr uint32_t VERSION = 2;
 };
 
-typedef struct SettingsRecord_V2 SettingsRecord_Latest;
+struct alignas(uint64_t) SettingsRecord_V3 final : public SettingsRecord
+{
+    SerialConfig SCLConfig;
+    bool SCLConfigFollowsUSB;
+    SerialConfig AuxConfig;
+    bool AuxConfigFollowsUSB;
+    uint32_t ShowPTRProgress;
+    uint32_t UppercaseMode;
+    uint32_t InputPacing;
+    uint32_t EchoTimeoutMS;
+    uint32_t PaceCharDelayMS;
+    uint32_t PaceLineDelayMS;
+    uint32_t PaceBurstSize;
+    uint32_t HostOverflowPolicy;
+    uint32_t AuxOverflowPolicy;
+    uint32_t FastLoad;
+    uint32_t HighSpeedLoad;
+    uint32_t VerifyLoad;
+    uint32_t ClearZeroRuns;
+    uint32_t ConsoleEntryAddr;
+    uint32_t CheckSum;
+
+    static constexpr uint32_t VERSION = 3;
+};
+
+typedef struct SettingsRecord_V3 SettingsRecord_Latest;
 
 SerialConfig Settings::SCLConfig = { SCL_DEFAULT_BAUD_RATE, 8, 1, SerialConfig::PARITY_NONE };
 bool Settings::SCLConfigFollowsUSB = true;
@@ -78,6 +104,20 @@ Settings::ShowPTRProgress_t Settings::ShowPTRProgress = Settings::ShowPTRProgres
 
 bool Settings::UppercaseMode;
 
+Settings::InputPacing_t Settings::InputPacing = Settings::InputPacing_Off;
+uint32_t Settings::EchoTimeoutMS = DEFAULT_ECHO_TIMEOUT_MS;
+uint32_t Settings::PaceCharDelayMS = DEFAULT_PACE_CHAR_DELAY_MS;
+uint32_t Settings::PaceLineDelayMS = DEFAULT_PACE_LINE_DELAY_MS;
+uint32_t Settings::PaceBurstSize = DEFAULT_PACE_BURST_SIZE;
+
+Port::OverflowPolicy_t Settings::HostOverflowPolicy = Port::OverflowPolicy_Block;
+Port::OverflowPolicy_t Settings::AuxOverflowPolicy = Port::OverflowPolicy_Block;
+bool Settings::FastLoad = false;
+bool Settings::HighSpeedLoad = false;
+bool Settings::ClearZeroRuns = false;
+uint16_t Settings::ConsoleEntryAddr = DEFAULT_CONSOLE_ENTRY_ADDR;
+Settings::VerifyLoad_t Settings::VerifyLoad = VerifyLoad_On;
+
 const SettingsRecord * Settings::sActiveRec;
 uint32_t Settings::sEraseCount;
 
@@ -98,6 +138,21 @@ static inline const uint8_t * GetFlashPage(const void * ptr)
     return (const uint8_t *)page;
 }
 
+// Convert a stored enum value to its enum type, substituting the given default
+// if the stored value is out of range.
+template<typename T>
+static inline T ToEnum(uint32_t val, T maxVal, T defaultVal)
+{
+    return (val <= (uint32_t)maxVal) ? (T)val : defaultVal;
+}
+
+// Return a stored numeric value, substituting the given default if the value
+// is outside the range accepted by the settings menu.
+static inline uint32_t InRange(uint32_t val, uint32_t minVal, uint32_t maxVal, uint32_t defaultVal)
+{
+    return (val >= minVal && val <= maxVal) ? val : defaultVal;
+}
+
 void Settings::Init(void)
 {
     sActiveRec = NULL;
@@ -124,8 +179,20 @@ void Settings::Init(void)
             SCLConfigFollowsUSB = recV1->SCLConfigFollowsUSB;
             AuxConfig = recV1->AuxConfig;
             AuxConfigFollowsUSB = recV1->AuxConfigFollowsUSB;
-            ShowPTRProgress  = (ShowPTRProgress_t)recV1->ShowPTRProgress;
+            ShowPTRProgress = ToEnum(recV1->ShowPTRProgress, ShowPTRProgress_Disabled, ShowPTRProgress_Enabled);
             UppercaseMode = false;
+            InputPacing = InputPacing_Off;
+            EchoTimeoutMS = DEFAULT_ECHO_TIMEOUT_MS;
+            PaceCharDelayMS = DEFAULT_PACE_CHAR_DELAY_MS;
+            PaceLineDelayMS = DEFAULT_PACE_LINE_DELAY_MS;
+            PaceBurstSize = DEFAULT_PACE_BURST_SIZE;
+            HostOverflowPolicy = Port::OverflowPolicy_Block;
+            AuxOverflowPolicy = Port::OverflowPolicy_Block;
+            FastLoad = false;
+            HighSpeedLoad = false;
+            VerifyLoad = VerifyLoad_On;
+            ClearZeroRuns = false;
+            ConsoleEntryAddr = DEFAULT_CONSOLE_ENTRY_ADDR;
         }
         else if (sActiveRec->RecordVersion == SettingsRecord_V2::VERSION) {
             auto recV2 = (const SettingsRecord_V2 *)sActiveRec;
@@ -133,8 +200,42 @@ void Settings::Init(void)
             SCLConfigFollowsUSB = recV2->SCLConfigFollowsUSB;
             AuxConfig = recV2->AuxConfig;
             AuxConfigFollowsUSB = recV2->AuxConfigFollowsUSB;
-            ShowPTRProgress  = (ShowPTRProgress_t)recV2->ShowPTRProgress;
+            ShowPTRProgress = ToEnum(recV2->ShowPTRProgress, ShowPTRProgress_Disabled, ShowPTRProgress_Enabled);
             UppercaseMode = (recV2->UppercaseMode != 0);
+            InputPacing = InputPacing_Off;
+            EchoTimeoutMS = DEFAULT_ECHO_TIMEOUT_MS;
+            PaceCharDelayMS = DEFAULT_PACE_CHAR_DELAY_MS;
+            PaceLineDelayMS = DEFAULT_PACE_LINE_DELAY_MS;
+            PaceBurstSize = DEFAULT_PACE_BURST_SIZE;
+            HostOverflowPolicy = Port::OverflowPolicy_Block;
+            AuxOverflowPolicy = Port::OverflowPolicy_Block;
+            FastLoad = false;
+            HighSpeedLoad = false;
+            VerifyLoad = VerifyLoad_On;
+            ClearZeroRuns = false;
+            ConsoleEntryAddr = DEFAULT_CONSOLE_ENTRY_ADDR;
+        }
+        else if (sActiveRec->RecordVersion == SettingsRecord_V3::VERSION) {
+            auto recV3 = (const SettingsRecord_V3 *)sActiveRec;
+            SCLConfig = recV3->SCLConfig;
+            SCLConfigFollowsUSB = recV3->SCLConfigFollowsUSB;
+            AuxConfig = recV3->AuxConfig;
+            AuxConfigFollowsUSB = recV3->AuxConfigFollowsUSB;
+            ShowPTRProgress = ToEnum(recV3->ShowPTRProgress, ShowPTRProgress_Disabled, ShowPTRProgress_Enabled);
+            UppercaseMode = (recV3->UppercaseMode != 0);
+            InputPacing = ToEnum(recV3->InputPacing, InputPacing_Fixed, InputPacing_Off);
+            EchoTimeoutMS = InRange(recV3->EchoTimeoutMS, MIN_ECHO_TIMEOUT_MS, MAX_ECHO_TIMEOUT_MS, DEFAULT_ECHO_TIMEOUT_MS);
+            PaceCharDelayMS = InRange(recV3->PaceCharDelayMS, 0, MAX_PACE_DELAY_MS, DEFAULT_PACE_CHAR_DELAY_MS);
+            PaceLineDelayMS = InRange(recV3->PaceLineDelayMS, 0, MAX_PACE_DELAY_MS, DEFAULT_PACE_LINE_DELAY_MS);
+            PaceBurstSize = InRange(recV3->PaceBurstSize, MIN_PACE_BURST_SIZE, MAX_PACE_BURST_SIZE, DEFAULT_PACE_BURST_SIZE);
+            HostOverflowPolicy = ToEnum(recV3->HostOverflowPolicy, Port::OverflowPolicy_DropNewest, Port::OverflowPolicy_Block);
+            AuxOverflowPolicy = ToEnum(recV3->AuxOverflowPolicy, Port::OverflowPolicy_DropNewest, Port::OverflowPolicy_Block);
+            FastLoad = (recV3->FastLoad != 0);
+            HighSpeedLoad = (recV3->HighSpeedLoad != 0);
+            VerifyLoad = ToEnum(recV3->VerifyLoad, VerifyLoad_Repair, VerifyLoad_On);
+            ClearZeroRuns = (recV3->ClearZeroRuns != 0);
+            ConsoleEntryAddr = ((recV3->ConsoleEntryAddr & 1) == 0 && recV3->ConsoleEntryAddr <= UINT16_MAX)
+                ? (uint16_t)recV3->ConsoleEntryAddr : DEFAULT_CONSOLE_ENTRY_ADDR;
         }
     }
 }
@@ -158,6 +259,18 @@ void Settings::Save(void)
     newRecData.AuxConfigFollowsUSB = AuxConfigFollowsUSB;
     newRecData.ShowPTRProgress = (uint8_t)ShowPTRProgress;
     newRecData.UppercaseMode = UppercaseMode;
+    newRecData.InputPacing = (uint8_t)InputPacing;
+    newRecData.EchoTimeoutMS = EchoTimeoutMS;
+    newRecData.PaceCharDelayMS = PaceCharDelayMS;
+    newRecData.PaceLineDelayMS = PaceLineDelayMS;
+    newRecData.PaceBurstSize = PaceBurstSize;
+    newRecData.HostOverflowPolicy = (uint8_t)HostOverflowPolicy;
+    newRecData.AuxOverflowPolicy = (uint8_t)AuxOverflowPolicy;
+    newRecData.FastLoad = FastLoad;
+    newRecData.HighSpeedLoad = HighSpeedLoad;
+    newRecData.VerifyLoad = (uint8_t)VerifyLoad;
+    newRecData.ClearZeroRuns = ClearZeroRuns;
+    newRecData.ConsoleEntryAddr = ConsoleEntryAddr;
     newRecData.CheckSum = newRecData.ComputeCheckSum();
 
     // Find the place in flash at which the new settings record should
@@ -190,6 +303,9 @@ void Settings::Save(void)
     // Update the copy with the new record data.
     memcpy(writeBuf + recOffsetInPage, (const uint8_t *)&newRecData, sizeof(newRecData));
 
+    // Arrange for core1 to execute from RAM while flash is being modified
+    Core1::BeginFlashOperation();
+
     // Disable interrupts while manipulating flash
     uint32_t intState = save_and_disable_interrupts();
 
@@ -207,6 +323,9 @@ void Settings::Save(void)
     // Restore interrupts.
     restore_interrupts(intState);
 
+    // Allow core1 to resume normal operation
+    Core1::EndFlashOperation();
+
     // Keep track of the most recently written settings record.
     sActiveRec = newRec;
 }
@@ -255,7 +374,8 @@ const SettingsRecord * Settings::FindEmptyRecord(bool& eraseSector)
 bool Settings::IsSupportedRecord(uint16_t recVer)
 {
     return (recVer == SettingsRecord_V1::VERSION ||
-            recVer == SettingsRecord_V2::VERSION);
+            recVer == SettingsRecord_V2::VERSION ||
+            recVer == SettingsRecord_V3::VERSION);
 }
 
 void Settings::PrintStats(Port& uiPort)
@@ -358,6 +478,11 @@ bool SettingsRecord::IsValid(void) const
                 return false;
             }
         }
+        else if (RecordVersion == SettingsRecord_V3::VERSION) {
+            if (RecordSize != sizeof(SettingsRecord_V3)) {
+                return false;
+            }
+        }
 
         // Verify that the full record does not overlap the end of the sector
         const uint8_t * recEnd = recStart + RecordSize;
@@ -376,6 +501,11 @@ bool SettingsRecord::IsValid(void) const
                 return false;
             }
         }
+        else if (RecordVersion == SettingsRecord_V3::VERSION) {
+            if (((const SettingsRecord_V3 *)this)->CheckSum != ComputeCheckSum()) {
+                return false;
+            }
+        }
     }
 
     // Otherwise, the record must be an empty record...
@@ -438,6 +568,11 @@ uint32_t SettingsRecord::ComputeCheckSum(void) const
             return crc32((const uint8_t *)recV2,
                          ((const uint8_t *)&recV2->CheckSum) - (const uint8_t *)recV2);
         }
+        else if (RecordVersion == SettingsRecord_V3::VERSION) {
+            auto recV3 = (const SettingsRecord_V3 *)this;
+            return crc32((const uint8_t *)recV3,
+                         ((const uint8_t *)&recV3->CheckSum) - (const uint8_t *)recV3);
+        }
     }
     return UINT32_MAX;
 }
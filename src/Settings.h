@@ -36,6 +36,32 @@ public:
     static ShowPTRProgress_t ShowPTRProgress;
     static bool UppercaseMode;
 
+    enum InputPacing_t : uint8_t {
+        InputPacing_Off,
+        InputPacing_Echo,
+        InputPacing_Fixed
+    };
+    static InputPacing_t InputPacing;
+    static uint32_t EchoTimeoutMS;
+    static uint32_t PaceCharDelayMS;
+    static uint32_t PaceLineDelayMS;
+    static uint32_t PaceBurstSize;
+
+    static Port::OverflowPolicy_t HostOverflowPolicy;
+    static Port::OverflowPolicy_t AuxOverflowPolicy;
+
+    static bool FastLoad;
+    static bool HighSpeedLoad;
+    static bool ClearZeroRuns;
+    static uint16_t ConsoleEntryAddr;
+
+    enum VerifyLoad_t : uint8_t {
+        VerifyLoad_Off,
+        VerifyLoad_On,
+        VerifyLoad_Repair
+    };
+    static VerifyLoad_t VerifyLoad;
+
     static void Init(void);
     static void Save(void);
     static bool ShouldShowPTRProgress(const Port * uiPort);
@@ -41,6 +41,27 @@ void SimpleDataSource::Advance(void)
     }
 }
 
+bool SimpleDataSource::GetRun(uint16_t& addr, const uint8_t *& data, size_t& len)
+{
+    // The run consists of the remainder of the buffer.
+    if (!AtEnd()) {
+        addr = (uint16_t)(mLoadAddr + mCurWord);
+        data = mDataBuf + mCurWord;
+        len = mDataLen - mCurWord;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+void SimpleDataSource::AdvanceRun(size_t len)
+{
+    if (!AtEnd()) {
+        mCurWord += MIN(len + 1, mDataLen - mCurWord + 1) & ~(size_t)1;
+    }
+}
+
 bool SimpleDataSource::AtEnd(void)
 {
     return mCurWord >= mDataLen;
@@ -50,3 +71,8 @@ uint16_t SimpleDataSource::GetStartAddress(void)
 {
     return NO_ADDR;
 }
+
+void SimpleDataSource::Rewind(void)
+{
+    mCurWord = 0;
+}
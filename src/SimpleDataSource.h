@@ -28,6 +28,9 @@ public:
     virtual void Advance(void);
     virtual bool AtEnd(void);
     virtual uint16_t GetStartAddress(void);
+    virtual void Rewind(void);
+    virtual bool GetRun(uint16_t& addr, const uint8_t *& data, size_t& len);
+    virtual void AdvanceRun(size_t len);
 
 private:
     const uint8_t * const mDataBuf;
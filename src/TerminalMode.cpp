@@ -19,13 +19,17 @@
 #include "ConsoleAdapter.h"
 #include "Settings.h"
 #include "PTRProgressBar.h"
+#include "InputPacer.h"
+#include "Core1.h"
 
 static void HandleHostSerialConfigChange(void);
 
 void TerminalMode(void)
 {
-    char ch;
+    char buf[64];
+    size_t len;
     Port *uiPort, *lastUIPort = &gHostPort;
+    uint32_t lastTapeReadCount = PaperTapeReader::ReadCount();
     
     while (true) {
 
@@ -37,24 +41,48 @@ void TerminalMode(void)
             HandleHostSerialConfigChange();
         }
 
-        // If the PDP-11 has triggered the READER RUN line and there's data
-        // available to be read from a paper tape file, then deliver a single
-        // byte from the paper tape to the SCL port.
-        if (gSCLPort.ReaderRunRequested() && PaperTapeReader::TryRead(ch)) {
-            gSCLPort.ClearReaderRunRequested();
-            gSCLPort.Write(ch);
+#if !defined(DUAL_CORE_MODE)
+        // Deliver a byte from the paper tape reader if the PDP-11 has
+        // requested one.  (In dual-core mode, this is done by core1).
+        PaperTapeReader::ServiceReaderRun();
+#endif
 
-            // Display/update the paper taper reader progress bar
+        // Display/update the paper taper reader progress bar whenever a
+        // byte has been read from the tape.
+        if (PaperTapeReader::ReadCount() != lastTapeReadCount) {
+            lastTapeReadCount = PaperTapeReader::ReadCount();
             PTRProgressBar::Update(lastUIPort);
         }
 
         // Process characters received from either the USB host or the auxiliary terminal.
-        if (gSCLPort.CanWrite() && TryReadHostAuxPorts(ch, uiPort)) {
-
-            // If the menu key was pressed enter menu mode
+        // Characters are read in bulk, limited to the amount of space available in the
+        // SCL port's transmit buffer, or in the input pacer's buffer if pacing is enabled.
+        len = ReadSomeHostAuxPorts(buf,
+            MIN(sizeof(buf), InputPacer::IsEnabled() ? InputPacer::Space() : gSCLPort.WriteSpace()),
+            uiPort);
+        for (size_t i = 0; i < len; i++) {
+            char ch = buf[i];
+
+            // If the menu key was pressed enter menu mode.  Discard any characters
+            // that followed the menu key in the same read, rather than sending them
+            // to the PDP-11 once the menu has been dismissed (possibly after a
+            // load or mount).  If the menu is displayed on the Aux port, suspend
+            // forwarding of output from the PDP-11 so that it doesn't interfere
+            // with the menu; output for the Host port is held by core1 until the
+            // menu is dismissed.
             if (ch == MENU_KEY) {
                 PTRProgressBar::Clear();
+                InputPacer::Pause();
+                if (uiPort != &gHostPort) {
+                    Core1::SuspendForwarding();
+                }
                 MenuMode(*uiPort);
+                if (uiPort != &gHostPort) {
+                    Core1::ResumeForwarding();
+                }
+                InputPacer::Resume();
+                lastUIPort = uiPort;
+                break;
             }
 
             // Otherwise forward the character to the SCL port...
@@ -65,17 +93,49 @@ void TerminalMode(void)
                     ch = toupper(ch);
                 }
 
-                gSCLPort.Write(ch);
+                // If input pacing is enabled, queue the character to be sent when
+                // the PDP-11 is ready for it.
+                if (InputPacer::IsEnabled()) {
+                    InputPacer::Enqueue(ch);
+                }
+                else {
+                    gSCLPort.Write(ch);
+                }
             }
 
             lastUIPort = uiPort;
         }
 
+        // Send queued input characters to the SCL port as the PDP-11 becomes ready
+        InputPacer::Service();
+
+#if defined(DUAL_CORE_MODE)
+        // Forward characters received from the SCL port to the Host port.  (In
+        // dual-core mode, core1 forwards the characters to the Aux port, and
+        // queues them for the Host port).  Clear the paper tape reader progress
+        // bar as soon as output arrives; core1 holds off forwarding the output
+        // while the progress bar is displayed.
+        if (gSCLPort.RxCount() > 0) {
+            PTRProgressBar::Clear();
+        }
+        len = Core1::ReadHostOutput(buf, sizeof(buf));
+        if (len > 0) {
+            InputPacer::NotifyReceived();
+            for (size_t i = 0; i < len; i++) {
+                gHostPort.Forward(buf[i], Settings::HostOverflowPolicy);
+            }
+        }
+#else
         // Forward characters received from the SCL port to both the Host and Aux ports
-        if (gSCLPort.TryRead(ch)) {
+        len = gSCLPort.ReadSome(buf, sizeof(buf));
+        if (len > 0) {
+            InputPacer::NotifyReceived();
             PTRProgressBar::Clear();
-            WriteHostAuxPorts(ch);
+            for (size_t i = 0; i < len; i++) {
+                ForwardHostAuxPorts(buf[i]);
+            }
         }
+#endif
 
         // Update the state of the activity LEDs
         ActivityLED::UpdateState();
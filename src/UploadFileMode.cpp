@@ -32,6 +32,8 @@ bool UploadFileMode(Port& uiPort)
     uint32_t blockNum;
     int rxLen;
     char ch;
+    char rxBuf[64];
+    size_t rxBufLen = 0, rxBufPos = 0;
     bool fileTooBig = false;
 
     const auto txChar = [](struct xmodem_server * /* xdm */, uint8_t byte, void *cbData) {
@@ -54,8 +56,18 @@ bool UploadFileMode(Port& uiPort)
         // Update the state of the activity LEDs
         ActivityLED::UpdateState();
 
-        // If a character is availabled from the sender...
-        if (uiPort.TryRead(ch)) {
+        // Read characters from the sender in bulk
+        if (rxBufPos == rxBufLen) {
+            rxBufLen = uiPort.ReadSome(rxBuf, sizeof(rxBuf));
+            rxBufPos = 0;
+        }
+
+        // Feed received characters to the XMODEM server until it has a complete
+        // packet to process.
+        while (rxBufPos < rxBufLen &&
+               xmodem_server_get_state(&xdm) != XMODEM_STATE_PROCESS_PACKET) {
+
+            ch = rxBuf[rxBufPos++];
 
             // If the file transfer is just starting, allow the sender to
             // abort by sending a Ctrl+C.
@@ -96,7 +108,7 @@ bool UploadFileMode(Port& uiPort)
         uint64_t waitEndTime = time_us_64() + 250000;
         while (time_us_64() < waitEndTime) {
             ActivityLED::UpdateState();
-            uiPort.TryRead(ch);
+            uiPort.ReadSome(rxBuf, sizeof(rxBuf));
         }
     }
 
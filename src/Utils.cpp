@@ -18,6 +18,7 @@
 #include <pico/printf.h>
 
 #include "ConsoleAdapter.h"
+#include "Settings.h"
 
 int Port::Printf(const char* format, ...)
 {
@@ -37,6 +38,19 @@ int Port::Printf(const char* format, ...)
     return result;
 }
 
+size_t Port::ReadSome(char * buf, size_t maxLen)
+{
+    size_t len = 0;
+
+    // Default implementation: read characters one at a time until no more
+    // are immediately available.
+    while (len < maxLen && TryRead(buf[len])) {
+        len++;
+    }
+
+    return len;
+}
+
 bool TryReadHostAuxPorts(char& ch) 
 {
     return gHostPort.TryRead(ch)
@@ -64,6 +78,33 @@ bool TryReadHostAuxPorts(char& ch, Port *& port)
     return false;
 }
 
+size_t ReadSomeHostAuxPorts(char * buf, size_t maxLen, Port *& port)
+{
+    size_t len;
+
+    if (maxLen == 0) {
+        port = NULL;
+        return 0;
+    }
+
+    len = gHostPort.ReadSome(buf, maxLen);
+    if (len > 0) {
+        port = &gHostPort;
+        return len;
+    }
+
+#if defined(AUX_TERM_UART)
+    len = gAuxPort.ReadSome(buf, maxLen);
+    if (len > 0) {
+        port = &gAuxPort;
+        return len;
+    }
+#endif
+
+    port = NULL;
+    return 0;
+}
+
 void WriteHostAuxPorts(char ch)
 {
     gHostPort.Write(ch);
@@ -79,3 +120,14 @@ void WriteHostAuxPorts(const char* str)
     gAuxPort.Write(str);
 #endif
 }
+
+void ForwardHostAuxPorts(char ch)
+{
+    // Forward the character to each port, applying the configured policy
+    // if the port's output buffer is full.  This prevents a slow port from
+    // throttling output to the other port, and to the PDP-11.
+    gHostPort.Forward(ch, Settings::HostOverflowPolicy);
+#if defined(AUX_TERM_UART)
+    gAuxPort.Forward(ch, Settings::AuxOverflowPolicy);
+#endif
+}
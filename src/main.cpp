@@ -21,6 +21,9 @@
 
 #include "ConsoleAdapter.h"
 #include "Settings.h"
+#include "Core1.h"
+
+static void InitRealTimeFunctions(void);
  
 int main()
 {
@@ -30,6 +33,25 @@ int main()
     // Initialize the host USB interface
     gHostPort.Init();
 
+    // Initialize the virtual paper tape reader
+    PaperTapeReader::Init();
+
+#if defined(DUAL_CORE_MODE)
+    // Start core1 and have it initialize the functions it owns.
+    Core1::Start(InitRealTimeFunctions);
+#else
+    InitRealTimeFunctions();
+#endif
+
+    // Initialize access to built-in file library.
+    FileLib::Init();
+
+    // Enter Terminal mode
+    TerminalMode();
+}
+
+void InitRealTimeFunctions(void)
+{
     // Initialize the SCL port and set the initial serial configuration
     gSCLPort.Init();
     gSCLPort.SetConfig(Settings::SCLConfig);
@@ -40,12 +62,6 @@ int main()
     gAuxPort.SetConfig(Settings::AuxConfig);
 #endif
 
-    // Initialize access to built-in file library.
-    FileLib::Init();
-
     // Initialize the activity LEDs
     ActivityLED::Init();
-
-    // Enter Terminal mode
-    TerminalMode();
 }